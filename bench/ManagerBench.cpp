@@ -0,0 +1,257 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : ManagerBench.cpp
+//  Author  : Anthony Islas
+//  Purpose : Compare batched Manager insert / lookup against per-item calls
+//  Group   : Bench
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "Manager.hpp"
+
+using namespace components::resources;
+
+typedef Manager< uint64_t, uint64_t > Manager_t;
+
+//
+// Lookups timed per size, repeated over the shuffled tags
+//
+static const size_t LOOKUPS = 4000000;
+
+//
+// Rounds the per-item lookups run with stats off and on, alternating, the best
+// of each is reported so drift on the machine hits both sides alike
+//
+static const size_t STATS_ROUNDS = 5;
+
+//**********************************************************************************
+//
+//  splitMix
+//
+//  \brief Next value of a splitmix64 sequence
+//
+//  \param u64State advanced in place
+//
+//  \return pseudo random value
+//
+//**********************************************************************************
+static uint64_t splitMix( uint64_t& u64State )
+{
+  uint64_t z = ( u64State += 0x9E3779B97F4A7C15ull );
+  z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ull;
+  z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBull;
+  return z ^ ( z >> 31 );
+}
+
+//**********************************************************************************
+//
+//  nanosPer
+//
+//  \brief Time fn( ) and divide by uiOps
+//
+//  \param uiOps operations done by fn
+//  \param fn
+//
+//  \return nanoseconds per operation
+//
+//**********************************************************************************
+template< typename Fn >
+static double nanosPer( size_t uiOps, Fn fn )
+{
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now( );
+  fn( );
+  std::chrono::steady_clock::time_point end   = std::chrono::steady_clock::now( );
+
+  return std::chrono::duration< double, std::nano >( end - start ).count( ) / uiOps;
+}
+
+//**********************************************************************************
+//
+//  getLoop
+//
+//  \brief Resolve every tag one getItem( ) at a time, then read the items
+//
+//  \param manager
+//  \param vTags     tags to look up, in order
+//  \param vItems    receives the pointers, one per tag
+//  \param uiLookups total lookups, whole passes over vTags
+//
+//  \return sum of the items
+//
+//**********************************************************************************
+static uint64_t getLoop( Manager_t&                     manager,
+                         const std::vector< uint64_t >& vTags,
+                         std::vector< uint64_t* >&      vItems,
+                         size_t                         uiLookups )
+{
+  uint64_t u64Sum = 0;
+
+  for ( size_t uiDone = 0; uiDone < uiLookups; uiDone += vTags.size( ) )
+  {
+    for ( size_t i = 0; i < vTags.size( ); i++ )
+    {
+      vItems[ i ] = manager.getItem( vTags[ i ] );
+    }
+    for ( size_t i = 0; i < vTags.size( ); i++ )
+    {
+      u64Sum += *vItems[ i ];
+    }
+  }
+
+  return u64Sum;
+}
+
+//**********************************************************************************
+//
+//  benchSize
+//
+//  \brief Run every comparison for one manager size and print a row
+//
+//  \param uiSize number of entries
+//
+//  \return checksum, printed so the lookups are not optimized out
+//
+//**********************************************************************************
+static uint64_t benchSize( size_t uiSize )
+{
+  std::vector< std::pair< uint64_t, uint64_t > > vPairs;
+  std::vector< uint64_t >                        vTags;
+  uint64_t                                       u64State = uiSize;
+  uint64_t                                       u64Sum   = 0;
+
+  vPairs.reserve( uiSize );
+  for ( size_t i = 0; i < uiSize; i++ )
+  {
+    uint64_t u64Tag = splitMix( u64State );
+    vPairs.push_back( std::make_pair( u64Tag, static_cast< uint64_t >( i ) ) );
+    vTags .push_back( u64Tag );
+  }
+
+  std::random_shuffle( vTags.begin( ), vTags.end( ) );
+
+  //
+  // Inserts
+  //
+  double fp64AddLoop = 0.0;
+  double fp64AddBulk = 0.0;
+  {
+    Manager_t manager;
+    fp64AddLoop = nanosPer( uiSize, [ & ]( )
+      {
+        for ( size_t i = 0; i < uiSize; i++ )
+        {
+          manager.addItem( vPairs[ i ].second, vPairs[ i ].first );
+        }
+      } );
+  }
+
+  Manager_t manager;
+  fp64AddBulk = nanosPer( uiSize, [ & ]( ) { manager.addItems( vPairs ); } );
+
+  //
+  // Lookups, in random order so every tag is a likely cache miss once the
+  // manager outgrows the caches. Both sides gather pointers first, as a scene
+  // resolving its sprites would. The per-item loop also runs with stats on,
+  // alternating with the plain one
+  //
+  size_t                   uiLookups = std::max( LOOKUPS, uiSize );
+  std::vector< uint64_t* > vItems( uiSize );
+
+  double fp64GetLoop  = 0.0;
+  double fp64GetStats = 0.0;
+
+  for ( size_t r = 0; r < STATS_ROUNDS; r++ )
+  {
+    double fp64Off = nanosPer( uiLookups, [ & ]( )
+      { u64Sum += getLoop( manager, vTags, vItems, uiLookups ); } );
+
+    manager.enableStats( "bench" );
+    double fp64On = nanosPer( uiLookups, [ & ]( )
+      { u64Sum += getLoop( manager, vTags, vItems, uiLookups ); } );
+    manager.disableStats( );
+
+    fp64GetLoop  = ( r == 0 ) ? fp64Off : std::min( fp64GetLoop,  fp64Off );
+    fp64GetStats = ( r == 0 ) ? fp64On  : std::min( fp64GetStats, fp64On  );
+  }
+
+  double fp64GetBulk = nanosPer( uiLookups, [ & ]( )
+    {
+      for ( size_t uiDone = 0; uiDone < uiLookups; uiDone += uiSize )
+      {
+        manager.getItems( vTags, vItems );
+        for ( size_t i = 0; i < uiSize; i++ )
+        {
+          u64Sum += *vItems[ i ];
+        }
+      }
+    } );
+
+  std::cout << std::setw( 10 ) << uiSize
+            << std::fixed << std::setprecision( 1 )
+            << std::setw( 12 ) << fp64AddLoop
+            << std::setw( 12 ) << fp64AddBulk
+            << std::setw( 12 ) << fp64GetLoop
+            << std::setw( 12 ) << fp64GetBulk
+            << std::setw( 9  ) << std::setprecision( 2 ) << fp64GetLoop / fp64GetBulk << "x"
+            << std::setw( 12 ) << std::setprecision( 1 ) << fp64GetStats
+            << std::endl;
+
+  return u64Sum;
+}
+
+//**********************************************************************************
+//
+//  main
+//
+//  \brief ManagerBench [ max entries ], defaults to 10M
+//
+//  \return 0
+//
+//**********************************************************************************
+int main( int argc, char** argv )
+{
+  size_t   uiMax  = ( argc > 1 ) ? std::strtoull( argv[ 1 ], nullptr, 10 ) : 10000000;
+  uint64_t u64Sum = 0;
+
+  std::cout << "ns per operation" << std::endl;
+  std::cout << std::setw( 10 ) << "entries"
+            << std::setw( 12 ) << "addItem"
+            << std::setw( 12 ) << "addItems"
+            << std::setw( 12 ) << "getItem"
+            << std::setw( 12 ) << "getItems"
+            << std::setw( 10 ) << "speedup"
+            << std::setw( 12 ) << "+stats"
+            << std::endl;
+
+  for ( size_t uiSize = 1000; uiSize <= uiMax; uiSize *= 100 )
+  {
+    u64Sum += benchSize( uiSize );
+  }
+
+  std::cout << "checksum " << u64Sum << std::endl;
+  return 0;
+}
@@ -0,0 +1,398 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+// 
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : ClockTest.cpp
+//  Author  : Anthony Islas
+//  Purpose : Unit test for clock stages and dataflow queues
+//  Group   : Components Unit Tests
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "Clock.hpp"
+#include "Queue.hpp"
+
+using namespace components::timing;
+
+TEST( ComponentsTestsClock, SpscQueueBounded )
+{
+  SpscQueue< int > queue( 3 );
+  int              iValue = 0;
+
+  ASSERT_EQ( queue.capacity( ), 4u );
+
+  for ( int i = 0; i < 4; i++ )
+  {
+    ASSERT_TRUE( queue.tryPush( i ) );
+  }
+  ASSERT_FALSE( queue.tryPush( 4 ) );
+
+  for ( int i = 0; i < 4; i++ )
+  {
+    ASSERT_TRUE( queue.tryPop( iValue ) );
+    ASSERT_EQ  ( iValue, i );
+  }
+  ASSERT_FALSE( queue.tryPop( iValue ) );
+}
+
+TEST( ComponentsTestsClock, MpmcQueueAllDelivered )
+{
+  MpmcQueue< int >           queue( 64 );
+  std::atomic< long long >   sum( 0 );
+  std::atomic< int >         popped( 0 );
+  std::vector< std::thread > vThreads;
+  const int                  iPerProducer = 10000;
+
+  for ( int p = 0; p < 2; p++ )
+  {
+    vThreads.push_back( std::thread( [ & ]( )
+      {
+        for ( int i = 1; i <= iPerProducer; i++ )
+        {
+          while ( !queue.tryPush( i ) ) { std::this_thread::yield( ); }
+        }
+      } ) );
+  }
+
+  for ( int c = 0; c < 2; c++ )
+  {
+    vThreads.push_back( std::thread( [ & ]( )
+      {
+        int iValue;
+        while ( popped.load( ) < 2 * iPerProducer )
+        {
+          if ( queue.tryPop( iValue ) )
+          {
+            sum    += iValue;
+            popped += 1;
+          }
+          else
+          {
+            std::this_thread::yield( );
+          }
+        }
+      } ) );
+  }
+
+  for ( size_t i = 0; i < vThreads.size( ); i++ )
+  {
+    vThreads[ i ].join( );
+  }
+
+  ASSERT_EQ( sum.load( ), 2LL * iPerProducer * ( iPerProducer + 1 ) / 2 );
+}
+
+//
+// Two stage pipeline, producer emits the tick, consumer checks ordering
+//
+class ProducerStage : public Stage
+{
+public:
+  OutputPort< uint64_t > out;
+
+  void process( uint64_t u64Tick ) { out.push( u64Tick ); }
+};
+
+class ConsumerStage : public Stage
+{
+public:
+  ConsumerStage( ) : received( 0 ), inOrder( true ) { }
+
+  InputPort< uint64_t >   in;
+  std::atomic< uint64_t > received;
+  std::atomic< bool >     inOrder;
+
+  void process( uint64_t u64Tick )
+  {
+    uint64_t u64Value;
+    if ( in.pop( u64Value ) )
+    {
+      if ( u64Value != u64Tick )
+      {
+        inOrder = false;
+      }
+      received++;
+    }
+  }
+};
+
+TEST( ComponentsTestsClock, PipelinedStages )
+{
+  Clock         clock;
+  ProducerStage producer;
+  ConsumerStage consumer;
+
+  clock.setFrequency( 1000.0 );
+  clock.registerStage( consumer, 1 );
+  clock.registerStage( producer, 0 );
+  clock.connect( producer.out, consumer.in, 4 );
+
+  clock.start( );
+
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::now( ) + std::chrono::seconds( 5 );
+
+  while ( consumer.received.load( ) < 20 && std::chrono::steady_clock::now( ) < deadline )
+  {
+    std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+  }
+
+  clock.stop( );
+
+  ASSERT_GE  ( consumer.received.load( ), 20u );
+  ASSERT_TRUE( consumer.inOrder.load( ) );
+  ASSERT_GE  ( clock.ticks( ), consumer.received.load( ) );
+}
+
+//
+// Listener that checks it is told about every tick once, in order, and only
+// after the stages are done with it
+//
+class OrderListener : public TickListener
+{
+public:
+  OrderListener( const ConsumerStage& consumer ) :
+                 consumer_( consumer ), before( 0 ), after( 0 ), inOrder( true ) { }
+
+  void beforeTick( uint64_t u64Tick )
+  {
+    inOrder = inOrder && u64Tick == before + 1;
+    before  = u64Tick;
+  }
+
+  void afterTick( uint64_t u64Tick )
+  {
+    inOrder = inOrder && u64Tick == after + 1 && u64Tick < before + 1 &&
+              consumer_.received.load( ) >= u64Tick;
+    after   = u64Tick;
+  }
+
+  const ConsumerStage& consumer_;
+  uint64_t             before;
+  uint64_t             after;
+  bool                 inOrder;
+};
+
+TEST( ComponentsTestsClock, ListenersKeepStagesPipelined )
+{
+  Clock         clock;
+  ProducerStage producer;
+  ConsumerStage consumer;
+  OrderListener listener( consumer );
+
+  clock.setFrequency( 1000.0 );
+  clock.registerStage( consumer, 1 );
+  clock.registerStage( producer, 0 );
+  clock.registerListener( listener, false );
+  clock.connect( producer.out, consumer.in, 4 );
+
+  clock.start( );
+
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::now( ) + std::chrono::seconds( 5 );
+
+  while ( consumer.received.load( ) < 20 && std::chrono::steady_clock::now( ) < deadline )
+  {
+    std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+  }
+
+  clock.stop( );
+
+  ASSERT_TRUE( listener.inOrder );
+  ASSERT_GE  ( listener.after, 10u );
+  ASSERT_TRUE( consumer.inOrder.load( ) );
+}
+
+//
+// A consumer waiting on an idle channel sleeps instead of spinning, and wakes
+// for each push and for close( )
+//
+TEST( ComponentsTestsClock, BlockedPortSleeps )
+{
+  std::shared_ptr< Channel< uint64_t > > pChannel(
+    new QueueChannel< uint64_t, SpscQueue< uint64_t > >( 4 ) );
+
+  OutputPort< uint64_t > out;
+  InputPort< uint64_t >  in;
+  out.attach( pChannel );
+  in .attach( pChannel );
+
+  std::atomic< uint64_t > received( 0 );
+
+  std::clock_t cStart = std::clock( );
+
+  std::thread consumer( [ & ]( )
+  {
+    uint64_t u64Value;
+    while ( in.pop( u64Value ) )
+    {
+      received++;
+    }
+  } );
+
+  for ( uint64_t i = 0; i < 10; i++ )
+  {
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    ASSERT_TRUE( out.push( i ) );
+  }
+
+  std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+  pChannel->close( );
+  consumer.join( );
+
+  double fp64Cpu = static_cast< double >( std::clock( ) - cStart ) / CLOCKS_PER_SEC;
+
+  ASSERT_EQ( received.load( ), 10u );
+  ASSERT_LT( fp64Cpu, 0.1 );
+}
+
+//
+// Pushes into a closed channel are refused even with room left, pops still
+// drain what was queued before close( )
+//
+TEST( ComponentsTestsClock, ClosedChannelRefusesPush )
+{
+  std::shared_ptr< Channel< uint64_t > > pChannel(
+    new QueueChannel< uint64_t, SpscQueue< uint64_t > >( 4 ) );
+
+  OutputPort< uint64_t > out;
+  InputPort< uint64_t >  in;
+  out.attach( pChannel );
+  in .attach( pChannel );
+
+  uint64_t u64Value = 0;
+
+  ASSERT_TRUE( out.push( 1 ) );
+  pChannel->close( );
+
+  ASSERT_FALSE( out.push( 2 ) );
+  ASSERT_FALSE( out.tryPush( 3 ) );
+
+  ASSERT_TRUE ( in.pop( u64Value ) );
+  ASSERT_EQ   ( u64Value, 1u );
+  ASSERT_FALSE( in.pop( u64Value ) );
+
+  pChannel->open( );
+  ASSERT_TRUE( out.tryPush( 4 ) );
+}
+
+//
+// Ticks recorded by the overlap test
+//
+const uint64_t OVERLAP_TICKS = 32;
+
+//
+// Consumer that runs past the period on odd ticks and catches up on even ones,
+// records when it ran each tick
+//
+class SlowConsumerStage : public Stage
+{
+public:
+  SlowConsumerStage( ) : done( 0 ) { }
+
+  InputPort< uint64_t >                 in;
+  std::chrono::steady_clock::time_point vStart[ OVERLAP_TICKS + 1 ];
+  std::chrono::steady_clock::time_point vEnd  [ OVERLAP_TICKS + 1 ];
+  std::atomic< uint64_t >               done;
+
+  void process( uint64_t u64Tick )
+  {
+    uint64_t u64Value;
+    in.pop( u64Value );
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now( );
+
+    if ( u64Tick % 2 == 1 )
+    {
+      std::this_thread::sleep_for( std::chrono::milliseconds( 6 ) );
+    }
+
+    if ( u64Tick <= OVERLAP_TICKS )
+    {
+      vStart[ u64Tick ] = start;
+      vEnd  [ u64Tick ] = std::chrono::steady_clock::now( );
+      done.store( u64Tick, std::memory_order_release );
+    }
+  }
+};
+
+class StampedProducerStage : public Stage
+{
+public:
+  OutputPort< uint64_t >                out;
+  std::chrono::steady_clock::time_point vStart[ OVERLAP_TICKS + 1 ];
+
+  void process( uint64_t u64Tick )
+  {
+    if ( u64Tick <= OVERLAP_TICKS )
+    {
+      vStart[ u64Tick ] = std::chrono::steady_clock::now( );
+    }
+    out.push( u64Tick );
+  }
+};
+
+//
+// The producer starts tick T + 1 while the consumer is still on T
+//
+TEST( ComponentsTestsClock, StagesOverlapTicks )
+{
+  Clock                clock;
+  StampedProducerStage producer;
+  SlowConsumerStage    consumer;
+
+  clock.setFrequency( 250.0 );
+  clock.registerStage( consumer, 1 );
+  clock.registerStage( producer, 0 );
+  clock.connect( producer.out, consumer.in, 64 );
+
+  clock.start( );
+
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::now( ) + std::chrono::seconds( 5 );
+
+  while ( consumer.done.load( std::memory_order_acquire ) < OVERLAP_TICKS &&
+          std::chrono::steady_clock::now( ) < deadline )
+  {
+    std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+  }
+
+  clock.stop( );
+
+  ASSERT_EQ( consumer.done.load( ), OVERLAP_TICKS );
+
+  size_t uiOverlaps = 0;
+
+  for ( uint64_t t = 1; t < OVERLAP_TICKS; t += 2 )
+  {
+    if ( consumer.vStart[ t ] < producer.vStart[ t + 1 ] &&
+         producer.vStart[ t + 1 ] < consumer.vEnd[ t ] )
+    {
+      uiOverlaps++;
+    }
+  }
+
+  ASSERT_GE( uiOverlaps, OVERLAP_TICKS / 4 );
+}
@@ -0,0 +1,755 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+// 
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : ManagerTest.cpp
+//  Author  : Anthony Islas
+//  Purpose : Unit test for resource manager
+//  Group   : Components Unit Tests
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "ConcurrentManager.hpp"
+#include "GsfLoader.hpp"
+#include "Manager.hpp"
+#include "Residency.hpp"
+#include "Stats.hpp"
+#include "config.hpp"
+
+using namespace components::resources;
+
+template< typename Index >
+class ComponentsTestsManager : public ::testing::Test
+{
+public:
+  typedef Manager< std::string, int, Index > Manager_t;
+};
+
+typedef ::testing::Types< FlatHashIndex< int >, SortedIndex< int > > IndexTypes;
+TYPED_TEST_CASE( ComponentsTestsManager, IndexTypes );
+
+TYPED_TEST( ComponentsTestsManager, AddGetRemove )
+{
+  typename TestFixture::Manager_t manager;
+
+  manager.addItem( "zero", 0 );
+  manager.addItem( "one",  1 );
+  manager.addItem( "two",  2 );
+
+  ASSERT_EQ( manager.size( ), 3u );
+  ASSERT_EQ( *manager.getItem( 1 ), "one" );
+  ASSERT_EQ(  manager.getItem( 3 ), nullptr );
+
+  //
+  // Replace in place
+  //
+  manager.addItem( "uno", 1 );
+  ASSERT_EQ( manager.size( ), 3u );
+  ASSERT_EQ( *manager.getItem( 1 ), "uno" );
+
+  ASSERT_TRUE ( manager.removeItem( 0 ) );
+  ASSERT_FALSE( manager.removeItem( 0 ) );
+  ASSERT_EQ   ( manager.size( ), 2u );
+  ASSERT_EQ   ( *manager.getItem( 2 ), "two" );
+  ASSERT_EQ   ( *manager.getItem( 1 ), "uno" );
+  ASSERT_FALSE( manager.hasItem( 0 ) );
+}
+
+TYPED_TEST( ComponentsTestsManager, MatchesMapUnderChurn )
+{
+  typename TestFixture::Manager_t manager;
+  std::map< int, std::string >    reference;
+
+  for ( int i = 0; i < 5000; i++ )
+  {
+    int iTag = ( i * 7919 ) % 1000;
+
+    if ( i % 3 == 0 )
+    {
+      ASSERT_EQ( manager.removeItem( iTag ), reference.erase( iTag ) == 1 );
+    }
+    else
+    {
+      manager.addItem( std::to_string( i ), iTag );
+      reference[ iTag ] = std::to_string( i );
+    }
+  }
+
+  ASSERT_EQ( manager.size( ), reference.size( ) );
+  ASSERT_EQ( manager.getItems( ).size( ), reference.size( ) );
+
+  for ( std::map< int, std::string >::iterator it = reference.begin( ); it != reference.end( ); it++ )
+  {
+    ASSERT_NE( manager.getItem( it->first ), nullptr );
+    ASSERT_EQ( *manager.getItem( it->first ), it->second );
+  }
+}
+
+TYPED_TEST( ComponentsTestsManager, HandlesDetectStale )
+{
+  typename TestFixture::Manager_t manager;
+
+  sHandle_t zero = manager.addItem( "zero", 0 );
+  sHandle_t one  = manager.addItem( "one",  1 );
+  sHandle_t two  = manager.addItem( "two",  2 );
+
+  ASSERT_EQ( *manager.getItem( one ), "one" );
+  ASSERT_EQ( manager.getHandle( 2 ).index, two.index );
+
+  //
+  // Removing the first item moves the last one, its handle must follow
+  //
+  ASSERT_TRUE ( manager.removeItem( zero ) );
+  ASSERT_FALSE( manager.isValid( zero ) );
+  ASSERT_EQ   ( manager.getItem( zero ), nullptr );
+  ASSERT_EQ   ( *manager.getItem( two ), "two" );
+
+  //
+  // Reused slot gets a new generation
+  //
+  sHandle_t three = manager.addItem( "three", 3 );
+  ASSERT_EQ   ( three.index, zero.index );
+  ASSERT_NE   ( three.generation, zero.generation );
+  ASSERT_EQ   ( manager.getItem( zero ), nullptr );
+  ASSERT_EQ   ( *manager.getItem( three ), "three" );
+  ASSERT_FALSE( manager.removeItem( zero ) );
+
+  manager.clear( );
+  ASSERT_FALSE( manager.isValid( one ) );
+  ASSERT_EQ   ( manager.getItems( ).size( ), 0u );
+}
+
+TYPED_TEST( ComponentsTestsManager, BatchesMatchSingleCalls )
+{
+  typename TestFixture::Manager_t manager;
+  std::vector< std::pair< int, std::string > > vPairs;
+
+  //
+  // Large enough for the pipelined lookup
+  //
+  for ( int i = 0; i < 70000; i++ )
+  {
+    vPairs.push_back( std::make_pair( i * 7, std::to_string( i ) ) );
+  }
+  manager.addItems( vPairs );
+  ASSERT_EQ( manager.size( ), 70000u );
+
+  std::vector< int >          vTags;
+  std::vector< std::string* > vItems( 80000 );
+
+  for ( int i = 0; i < 80000; i++ )
+  {
+    vTags.push_back( i * 7 );
+  }
+
+  ASSERT_EQ( manager.getItems( vTags, vItems ), 70000u );
+
+  for ( int i = 0; i < 80000; i++ )
+  {
+    ASSERT_EQ( vItems[ i ], manager.getItem( vTags[ i ] ) );
+  }
+}
+
+TEST( ComponentsTestsConcurrentManager, SnapshotsStayConsistent )
+{
+  ConcurrentManager< int, int > manager( 8 );
+  std::atomic< bool >           done( false );
+  std::atomic< bool >           consistent( true );
+  std::vector< std::thread >    vReaders;
+  const int                     iCount = 2000;
+
+  for ( int r = 0; r < 4; r++ )
+  {
+    vReaders.push_back( std::thread( [ & ]( )
+      {
+        while ( !done.load( ) )
+        {
+          //
+          // Writer adds 0, 1, 2 ... in order, any snapshot must be a prefix
+          //
+          std::vector< int > vItems = manager.getItems( );
+          std::sort( vItems.begin( ), vItems.end( ) );
+          for ( size_t i = 0; i < vItems.size( ); i++ )
+          {
+            if ( vItems[ i ] != static_cast< int >( i ) )
+            {
+              consistent = false;
+            }
+          }
+
+          int iValue;
+          if ( manager.getItem( 0, iValue ) && iValue != 0 )
+          {
+            consistent = false;
+          }
+        }
+      } ) );
+  }
+
+  for ( int i = 0; i < iCount; i++ )
+  {
+    manager.addItem( i, i );
+  }
+  done = true;
+
+  for ( size_t i = 0; i < vReaders.size( ); i++ )
+  {
+    vReaders[ i ].join( );
+  }
+
+  ASSERT_TRUE ( consistent.load( ) );
+  ASSERT_EQ   ( manager.size( ), static_cast< size_t >( iCount ) );
+  ASSERT_TRUE ( manager.removeItem( 7 ) );
+  ASSERT_FALSE( manager.hasItem( 7 ) );
+  ASSERT_FALSE( manager.removeItem( 7 ) );
+
+  EpochDomain::instance( ).collect( );
+  ASSERT_EQ( EpochDomain::instance( ).pending( ), 0u );
+}
+
+TEST( ComponentsTestsConcurrentManager, BatchesPublishAtOnce )
+{
+  ConcurrentManager< int, int > manager( 8 );
+  std::atomic< bool >           done( false );
+  std::atomic< bool >           consistent( true );
+  const int                     iBatch   = 500;
+  const int                     iBatches = 20;
+
+  std::thread reader( [ & ]( )
+    {
+      while ( !done.load( ) )
+      {
+        //
+        // Whole batches or nothing, whichever shards they landed in
+        //
+        if ( manager.size( ) % iBatch != 0 )
+        {
+          consistent = false;
+        }
+      }
+    } );
+
+  for ( int b = 0; b < iBatches; b++ )
+  {
+    std::vector< std::pair< int, int > > vItems;
+    for ( int i = b * iBatch; i < ( b + 1 ) * iBatch; i++ )
+    {
+      vItems.push_back( std::make_pair( i, i * 2 ) );
+    }
+    manager.addItems( vItems );
+  }
+
+  std::vector< int > vTags;
+  for ( int i = 0; i < iBatch; i++ )
+  {
+    vTags.push_back( i * iBatches );
+  }
+  vTags.push_back( -1 );
+
+  size_t uiRemoved = manager.removeItems( Span< const int >( vTags ) );
+  done = true;
+  reader.join( );
+
+  ASSERT_TRUE( consistent.load( ) );
+  ASSERT_EQ  ( uiRemoved, static_cast< size_t >( iBatch ) );
+  ASSERT_EQ  ( manager.size( ), static_cast< size_t >( iBatch * ( iBatches - 1 ) ) );
+
+  int iValue;
+  ASSERT_FALSE( manager.hasItem( 0 ) );
+  ASSERT_TRUE ( manager.getItem( 1, iValue ) );
+  ASSERT_EQ   ( iValue, 2 );
+
+  EpochDomain::instance( ).collect( );
+  ASSERT_EQ( EpochDomain::instance( ).pending( ), 0u );
+}
+
+TEST( ComponentsTestsManagerAsync, DeduplicatesLoads )
+{
+  Manager< std::string, int > manager;
+  std::atomic< int >          loads( 0 );
+  LoaderPool                  pool( 2 );
+
+  manager.setLoader( [ & ]( const int& iTag )
+                     {
+                       loads++;
+                       std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+                       return std::to_string( iTag );
+                     }, pool );
+
+  std::shared_future< sHandle_t > first  = manager.getItemAsync( 5 );
+  std::shared_future< sHandle_t > second = manager.getItemAsync( 5 );
+
+  ASSERT_EQ( manager.pendingLoads( ), 1u );
+  ASSERT_EQ( manager.getItem( 5 ),   nullptr );
+
+  while ( manager.pendingLoads( ) != 0 )
+  {
+    manager.pollLoads( );
+    std::this_thread::yield( );
+  }
+
+  ASSERT_EQ( loads.load( ), 1 );
+  ASSERT_EQ( *manager.getItem( first.get( ) ),  "5" );
+  ASSERT_EQ( *manager.getItem( second.get( ) ), "5" );
+
+  //
+  // Resident items resolve without loading
+  //
+  ASSERT_EQ( manager.getItemAsync( 5 ).wait_for( std::chrono::seconds( 0 ) ),
+             std::future_status::ready );
+  ASSERT_EQ( loads.load( ), 1 );
+}
+
+TEST( ComponentsTestsManagerAsync, LoadsGsf )
+{
+  Manager< components::sParseElement_t, std::string > manager;
+  std::string ssFile( std::string ( TEST_RESOURCES ) + "template.gsf" );
+
+  manager.setLoader( GsfLoader( ) );
+
+  std::shared_future< sHandle_t > future = manager.getItemAsync( ssFile );
+
+  while ( manager.pollLoads( ) == 0 )
+  {
+    std::this_thread::yield( );
+  }
+
+  ASSERT_FALSE( manager.getItem( future.get( ) )->vElementLines.empty( ) );
+}
+
+TEST( ComponentsTestsManagerAsync, MissingGsfFails )
+{
+  Manager< components::sParseElement_t, std::string > manager;
+  std::string ssFile( std::string ( TEST_RESOURCES ) + "missing.gsf" );
+
+  manager.setLoader( GsfLoader( ) );
+
+  std::shared_future< sHandle_t > future = manager.getItemAsync( ssFile );
+
+  while ( manager.pollLoads( ) == 0 )
+  {
+    std::this_thread::yield( );
+  }
+
+  ASSERT_THROW( future.get( ), std::runtime_error );
+  ASSERT_FALSE( manager.hasItem( ssFile ) );
+  ASSERT_EQ   ( manager.size( ), 0u );
+}
+
+TEST( ComponentsTestsManagerEviction, EvictsUnpinnedAndReloads )
+{
+  Manager< int, int, FlatHashIndex< int >, ClockEviction< > > manager;
+  int                                                          iLoads = 0;
+
+  manager.eviction( ).setBudget( 4 * sizeof( int ) );
+  manager.setLoader( [ & ]( const int& iTag ) { iLoads++; return iTag * 10; } );
+
+  sHandle_t pinned = manager.addItem( 0, 0 );
+  ASSERT_TRUE( manager.pin( pinned ) );
+
+  for ( int i = 1; i < 100; i++ )
+  {
+    manager.addItem( i * 10, i );
+    ASSERT_LE( manager.eviction( ).bytes( ), manager.eviction( ).budget( ) );
+  }
+
+  ASSERT_EQ( manager.size( ), 4u );
+  ASSERT_TRUE( manager.hasItem( 0 ) );
+  ASSERT_TRUE( manager.hasItem( 99 ) );
+  ASSERT_EQ( *manager.getItem( pinned ), 0 );
+
+  //
+  // Evicted items come back through the loader, stale handles stay stale
+  //
+  sHandle_t evicted = manager.getHandle( 98 );
+  manager.addItem( 1000, 100 );
+  manager.addItem( 1010, 101 );
+  manager.addItem( 1020, 102 );
+  ASSERT_FALSE( manager.isValid( evicted ) );
+
+  ASSERT_EQ( *manager.getItem( 50 ), 500 );
+  ASSERT_EQ( iLoads, 1 );
+  ASSERT_TRUE( manager.hasItem( 0 ) );
+
+  ASSERT_TRUE ( manager.unpin( pinned ) );
+  ASSERT_FALSE( manager.isPinned( pinned ) );
+
+  manager.eviction( ).setBudget( sizeof( int ) );
+  ASSERT_EQ( manager.evict( ), 3u );
+  ASSERT_EQ( manager.size( ), 1u );
+}
+
+TEST( ComponentsTestsManagerEviction, PinsOverBudget )
+{
+  Manager< int, int, FlatHashIndex< int >, ClockEviction< > > manager;
+  std::vector< sHandle_t >                                     vPinned;
+
+  manager.eviction( ).setBudget( 4 * sizeof( int ) );
+
+  for ( int i = 0; i < 8; i++ )
+  {
+    vPinned.push_back( manager.addItem( i, i ) );
+    ASSERT_TRUE( manager.pin( vPinned.back( ) ) );
+  }
+
+  ASSERT_EQ( manager.eviction( ).pinned( ), 8 * sizeof( int ) );
+
+  //
+  // Nothing can get back under budget, each insert evicts every unpinned item
+  // but itself and the pinned ones stay
+  //
+  for ( int i = 8; i < 100; i++ )
+  {
+    manager.addItem( i, i );
+    ASSERT_EQ( manager.size( ), 9u );
+  }
+
+  ASSERT_TRUE( manager.hasItem( 99 ) );
+  ASSERT_EQ  ( manager.evict( ), 1u );
+  ASSERT_EQ  ( manager.evict( ), 0u );
+  ASSERT_EQ  ( manager.size( ), 8u );
+
+  for ( int i = 0; i < 8; i++ )
+  {
+    ASSERT_TRUE( manager.hasItem( i ) );
+  }
+
+  //
+  // Pinned bytes follow replacement and removal of pinned items
+  //
+  manager.addItem( 70, 7 );
+  ASSERT_EQ  ( manager.eviction( ).pinned( ), 8 * sizeof( int ) );
+  ASSERT_TRUE( manager.removeItem( 7 ) );
+  ASSERT_EQ  ( manager.eviction( ).pinned( ), 7 * sizeof( int ) );
+
+  for ( int i = 0; i < 7; i++ )
+  {
+    ASSERT_TRUE( manager.unpin( vPinned[ i ] ) );
+  }
+
+  ASSERT_EQ( manager.eviction( ).pinned( ), 0u );
+  ASSERT_EQ( manager.evict( ), 3u );
+  ASSERT_EQ( manager.eviction( ).bytes( ), manager.eviction( ).budget( ) );
+
+  //
+  // Exactly at budget with pins, the new item is all that could go
+  //
+  for ( size_t i = 0; i < 4; i++ )
+  {
+    ASSERT_TRUE( manager.pin( manager.getHandle( manager.getTags( )[ i ] ) ) );
+  }
+
+  manager.addItem( 1000, 1000 );
+  ASSERT_EQ  ( manager.size( ), 5u );
+  ASSERT_TRUE( manager.hasItem( 1000 ) );
+}
+
+//
+// Reads two tags a tick through the const lookups and declares the two it will
+// read the next tick
+//
+typedef Manager< int, int, FlatHashIndex< int >, ClockEviction< > > Budgeted_t;
+typedef ResidencyPlanner< int, int, FlatHashIndex< int >, ClockEviction< > > Planner_t;
+
+class ReaderStage : public components::timing::Stage
+{
+public:
+  ReaderStage( const Budgeted_t& manager, Planner_t& planner ) :
+               manager_( manager ), planner_( planner ), ticks( 0 ), misses( 0 ) { }
+
+  static int tagOf( uint64_t u64Tick, int i ) { return static_cast< int >( ( u64Tick * 3 + i ) % 16 ); }
+
+  void process( uint64_t u64Tick )
+  {
+    for ( int i = 0; i < 2; i++ )
+    {
+      int        iTag  = tagOf( u64Tick, i );
+      const int* pItem = manager_.getItem( iTag );
+
+      if ( pItem == nullptr || *pItem != iTag * 10 || !manager_.isPinned( manager_.getHandle( iTag ) ) )
+      {
+        misses++;
+      }
+
+      planner_.declare( u64Tick + 1, tagOf( u64Tick + 1, i ) );
+    }
+    ticks++;
+  }
+
+  const Budgeted_t&       manager_;
+  Planner_t&              planner_;
+  std::atomic< uint64_t > ticks;
+  std::atomic< uint64_t > misses;
+};
+
+TEST( ComponentsTestsManagerResidency, DeclaredItemsResidentDuringTick )
+{
+  Budgeted_t                manager;
+  Planner_t                 planner( manager );
+  ReaderStage               reader( manager, planner );
+  components::timing::Clock clock;
+
+  //
+  // Room for the tick being read and the one being loaded only, every tick
+  // evicts older ones
+  //
+  manager.eviction( ).setBudget( 4 * sizeof( int ) );
+  manager.setLoader( [ ]( const int& iTag ) { return iTag * 10; } );
+
+  planner.declare( 1, ReaderStage::tagOf( 1, 0 ) );
+  planner.declare( 1, ReaderStage::tagOf( 1, 1 ) );
+
+  clock.setFrequency( 200.0 );
+  clock.registerStage( reader, 0 );
+  clock.registerListener( planner, std::vector< components::timing::Stage* >( 1, &reader ) );
+  clock.start( );
+
+  std::chrono::steady_clock::time_point deadline =
+    std::chrono::steady_clock::now( ) + std::chrono::seconds( 5 );
+
+  while ( reader.ticks.load( ) < 20 && std::chrono::steady_clock::now( ) < deadline )
+  {
+    std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+  }
+
+  clock.stop( );
+
+  //
+  // Every item a stage missed is one whose load had not finished in time. Loads
+  // declared a tick ahead finish in the gap, only tick 1's, started right before
+  // it, may miss
+  //
+  ASSERT_GE( reader.ticks.load( ), 20u );
+  ASSERT_EQ( reader.misses.load( ), planner.missing( ) );
+  ASSERT_LE( planner.missing( ), 2u );
+  ASSERT_LE( manager.size( ), 4u );
+}
+
+TEST( ComponentsTestsManagerStats, CountersMergeAcrossThreads )
+{
+  Budgeted_t                 manager;
+  const Budgeted_t&          rReader    = manager;
+  size_t                     uiManagers = StatsRegistry::size( );
+  std::vector< std::thread > vThreads;
+
+  manager.eviction( ).setBudget( 8 * sizeof( int ) );
+  manager.enableStats( "stats-test" );
+  ASSERT_EQ( StatsRegistry::size( ), uiManagers + 1 );
+
+  for ( int i = 0; i < 16; i++ )
+  {
+    manager.addItem( i, i );
+  }
+
+  //
+  // Readers on their own threads, each counting into its own slot
+  //
+  for ( int t = 0; t < 4; t++ )
+  {
+    vThreads.push_back( std::thread( [ & ]( )
+      {
+        for ( int i = 0; i < 1000; i++ )
+        {
+          rReader.getItem( 8 + i % 8 );
+        }
+        for ( int i = 0; i < 100; i++ )
+        {
+          rReader.getItem( 100 );
+        }
+      } ) );
+  }
+  for ( size_t t = 0; t < vThreads.size( ); t++ )
+  {
+    vThreads[ t ].join( );
+  }
+
+  sStatsSnapshot_t sSnapshot = manager.stats( )->snapshot( );
+  uint64_t         u64Samples = 0;
+
+  for ( size_t b = 0; b < STATS_BUCKETS; b++ )
+  {
+    u64Samples += sSnapshot.latency[ b ];
+  }
+
+  ASSERT_EQ( sSnapshot.counters[ STATS_LOOKUPS   ], 4400u );
+  ASSERT_EQ( sSnapshot.counters[ STATS_MISSES    ], 400u );
+  ASSERT_EQ( sSnapshot.counters[ STATS_INSERTS   ], 16u );
+  ASSERT_EQ( sSnapshot.counters[ STATS_EVICTIONS ], 8u );
+  ASSERT_EQ( sSnapshot.items, 8u );
+  ASSERT_EQ( sSnapshot.bytes, 8 * sizeof( int ) );
+  ASSERT_GT( u64Samples, 0u );
+
+  std::ostringstream ssJson;
+  StatsRegistry::writeJson( ssJson );
+  ASSERT_NE( ssJson.str( ).find( "\"name\":\"stats-test\",\"lookups\":4400,\"misses\":400" ),
+             std::string::npos );
+  ASSERT_NE( ssJson.str( ).find( "\"hits\":4000" ), std::string::npos );
+
+  manager.disableStats( );
+  ASSERT_EQ( StatsRegistry::size( ), uiManagers );
+}
+
+TEST( ComponentsTestsManagerStats, PendingLookupsFollowTheirManager )
+{
+  Budgeted_t first;
+  Budgeted_t second;
+
+  first .addItem( 1, 1 );
+  second.addItem( 2, 2 );
+  first .enableStats( "first" );
+  second.enableStats( "second" );
+
+  //
+  // Alternating managers hands the pending lookups back on every switch
+  //
+  for ( int i = 0; i < 100; i++ )
+  {
+    first .getItem( 1 );
+    second.getItem( 2 );
+    second.getItem( 2 );
+  }
+
+  ASSERT_EQ( first .stats( )->snapshot( ).counters[ STATS_LOOKUPS ], 100u );
+  ASSERT_EQ( second.stats( )->snapshot( ).counters[ STATS_LOOKUPS ], 200u );
+
+  //
+  // A live thread's pending lookups and misses are merged on read
+  //
+  std::atomic< bool > bLooked( false );
+  std::atomic< bool > bRead( false );
+
+  std::thread worker( [ & ]( )
+    {
+      for ( int i = 0; i < 30; i++ )
+      {
+        first.getItem( i < 10 ? 5 : 1 );
+      }
+      bLooked = true;
+
+      while ( !bRead )
+      {
+        std::this_thread::yield( );
+      }
+    } );
+
+  while ( !bLooked )
+  {
+    std::this_thread::yield( );
+  }
+
+  sStatsSnapshot_t sLive = first.stats( )->snapshot( );
+  bRead = true;
+  worker.join( );
+
+  ASSERT_EQ( sLive.counters[ STATS_LOOKUPS ], 130u );
+  ASSERT_EQ( sLive.counters[ STATS_MISSES  ], 10u );
+  ASSERT_EQ( first.stats( )->snapshot( ).counters[ STATS_LOOKUPS ], 130u );
+
+  //
+  // Pending lookups of destroyed stats are dropped, by this thread on its next
+  // switch and by a reader on exit
+  //
+  std::atomic< bool > bCounted( false );
+  std::atomic< bool > bDisabled( false );
+
+  std::thread reader( [ & ]( )
+    {
+      second.getItem( 2 );
+      bCounted = true;
+
+      while ( !bDisabled )
+      {
+        std::this_thread::yield( );
+      }
+    } );
+
+  while ( !bCounted )
+  {
+    std::this_thread::yield( );
+  }
+
+  second.disableStats( );
+  bDisabled = true;
+  reader.join( );
+
+  first.getItem( 1 );
+  ASSERT_EQ( first.stats( )->snapshot( ).counters[ STATS_LOOKUPS ], 131u );
+}
+
+TEST( ComponentsTestsManagerStorage, PooledItemsStayPutAndRecycle )
+{
+  typedef std::vector< double > Item_t;
+  typedef Manager< Item_t, int, FlatHashIndex< int >, NoEviction, PooledStorage< Item_t > > Pooled_t;
+
+  Pooled_t manager;
+
+  sHandle_t     first  = manager.emplaceItem( 0, 16, 1.0 );
+  const Item_t* pFirst = manager.getItem( first );
+
+  for ( int i = 1; i < 200; i++ )
+  {
+    manager.emplaceItem( i, 16, static_cast< double >( i ) );
+  }
+  for ( int i = 1; i < 200; i += 2 )
+  {
+    manager.removeItem( i );
+  }
+
+  //
+  // Items never move, the pointer survives growth and swap-removal
+  //
+  ASSERT_EQ( manager.getItem( first ), pFirst );
+  ASSERT_EQ( ( *pFirst )[ 15 ], 1.0 );
+  ASSERT_EQ( manager.size( ), 100u );
+
+  double fp64Sum = 0.0;
+  for ( const Item_t& item : manager.getItems( ) )
+  {
+    fp64Sum += item[ 0 ];
+  }
+  ASSERT_EQ( fp64Sum, 9901.0 );
+
+  //
+  // Steady state churn reuses blocks
+  //
+  size_t uiSlabs = SlabPool< Item_t >::shared( ).slabs( );
+
+  for ( int iRound = 0; iRound < 10; iRound++ )
+  {
+    for ( int i = 1; i < 200; i += 2 )
+    {
+      manager.emplaceItem( i, 4, 0.0 );
+    }
+    for ( int i = 1; i < 200; i += 2 )
+    {
+      manager.removeItem( i );
+    }
+  }
+
+  ASSERT_EQ( SlabPool< Item_t >::shared( ).slabs( ), uiSlabs );
+}
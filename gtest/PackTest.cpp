@@ -0,0 +1,204 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+// 
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : PackTest.cpp
+//  Author  : Anthony Islas
+//  Purpose : Unit test for pack building and memory mapped lookups
+//  Group   : Components Unit Tests
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "PackManager.hpp"
+#include "Parser.hpp"
+#include "config.hpp"
+
+using namespace components;
+using namespace components::resources;
+
+//
+// Compare a mapped tree against the parser's
+//
+static void expectSameTree( const PackNode& node, const sParseElement_t& sElem )
+{
+  ASSERT_EQ( node.lines( ),    sElem.vElementLines.size( ) );
+  ASSERT_EQ( node.children( ), sElem.vChildren.size( ) );
+
+  for ( size_t i = 0; i < node.lines( ); i++ )
+  {
+    Span< const char > ssLine = node.line( i );
+    ASSERT_EQ( std::string( ssLine.begin( ), ssLine.end( ) ), sElem.vElementLines[ i ] );
+  }
+
+  for ( size_t i = 0; i < node.children( ); i++ )
+  {
+    expectSameTree( node.child( i ), sElem.vChildren[ i ] );
+  }
+}
+
+TEST( ComponentsTestsPack, ServesRawAndGsfEntries )
+{
+  std::string ssGsf ( std::string ( TEST_RESOURCES ) + "template.gsf" );
+  std::string ssPack( ::testing::TempDir( ) + "components_test.pack" );
+  Parser      parser;
+  PackBuilder builder;
+
+  for ( int i = 0; i < 100; i++ )
+  {
+    std::string ssData( i, static_cast< char >( 'a' + i % 26 ) );
+    builder.addRaw( "raw/" + std::to_string( i ), ssData.data( ), ssData.size( ) );
+  }
+  ASSERT_TRUE( builder.addGsf( "template.gsf", ssGsf, parser ) );
+  ASSERT_TRUE( builder.write( ssPack ) );
+
+  PackManager manager;
+  ASSERT_TRUE( manager.open( ssPack ) );
+  ASSERT_EQ  ( manager.size( ), 101u );
+
+  for ( int i = 0; i < 100; i++ )
+  {
+    PackItem item = manager.getItem( "raw/" + std::to_string( i ) );
+
+    ASSERT_TRUE( item.valid( ) );
+    ASSERT_EQ  ( item.type( ), PACK_RAW );
+    ASSERT_EQ  ( std::string( item.bytes( ).begin( ), item.bytes( ).end( ) ),
+                 std::string( i, static_cast< char >( 'a' + i % 26 ) ) );
+    ASSERT_EQ  ( reinterpret_cast< uintptr_t >( item.bytes( ).data( ) ) % 8, 0u );
+  }
+
+  PackItem gsf = manager.getItem( "template.gsf" );
+  ASSERT_EQ( gsf.type( ), PACK_GSF );
+  expectSameTree( gsf.root( ), parser.ParseFile( ssGsf ) );
+  ASSERT_FALSE( gsf.root( ).toElement( ).vChildren.empty( ) );
+
+  ASSERT_FALSE( manager.getItem( "raw/100" ).valid( ) );
+  ASSERT_FALSE( manager.hasItem( "missing" ) );
+
+  //
+  // Handles go stale with the mapping
+  //
+  sHandle_t handle = manager.getHandle( "raw/7" );
+  ASSERT_TRUE( manager.getItem( handle ).valid( ) );
+  ASSERT_TRUE( manager.open( ssPack ) );
+  ASSERT_FALSE( manager.getItem( handle ).valid( ) );
+
+  manager.close( );
+  ASSERT_FALSE( manager.open( ssGsf ) );
+  ASSERT_FALSE( manager.isOpen( ) );
+}
+
+TEST( ComponentsTestsPack, RewriteKeepsOpenPackMapped )
+{
+  std::string ssPack( ::testing::TempDir( ) + "components_rewrite.pack" );
+  std::string ssOld ( 4096 * 4, 'o' );
+  std::string ssNew ( 16, 'n' );
+
+  PackBuilder before;
+  before.addRaw( "data", ssOld.data( ), ssOld.size( ) );
+  ASSERT_TRUE( before.write( ssPack ) );
+
+  PackManager manager;
+  ASSERT_TRUE( manager.open( ssPack ) );
+
+  //
+  // The new pack replaces the file, the open mapping keeps the old one
+  //
+  PackBuilder after;
+  after.addRaw( "data", ssNew.data( ), ssNew.size( ) );
+  ASSERT_TRUE( after.write( ssPack ) );
+
+  PackItem item = manager.getItem( "data" );
+  ASSERT_EQ( std::string( item.bytes( ).begin( ), item.bytes( ).end( ) ), ssOld );
+
+  ASSERT_TRUE( manager.open( ssPack ) );
+  item = manager.getItem( "data" );
+  ASSERT_EQ( std::string( item.bytes( ).begin( ), item.bytes( ).end( ) ), ssNew );
+}
+
+//
+// Write a copy of a pack with one 32 bit field of its only entry's tree changed
+//
+static std::string corruptTree( const std::string& ssPack, size_t uiField, uint32_t u32Value )
+{
+  std::ifstream       ifFile( ssPack.c_str( ), std::ios::binary );
+  std::vector< char > vData( ( std::istreambuf_iterator< char >( ifFile ) ),
+                             std::istreambuf_iterator< char >( ) );
+
+  sPackHeader_t sHeader;
+  std::memcpy( &sHeader, vData.data( ), sizeof( sHeader ) );
+  std::memcpy( vData.data( ) + sHeader.dataOffset + uiField * sizeof( uint32_t ),
+               &u32Value, sizeof( u32Value ) );
+
+  std::string   ssCorrupt( ssPack + ".corrupt" );
+  std::ofstream ofFile( ssCorrupt.c_str( ), std::ios::binary | std::ios::trunc );
+  ofFile.write( vData.data( ), vData.size( ) );
+  return ssCorrupt;
+}
+
+TEST( ComponentsTestsPack, RejectsCorruptTree )
+{
+  std::string     ssPack( ::testing::TempDir( ) + "components_tree.pack" );
+  sParseElement_t sElem;
+  sParseElement_t sChild;
+
+  sChild.vElementLines.push_back( "child" );
+  sElem .vElementLines.push_back( "root" );
+  sElem .vChildren.push_back( sChild );
+
+  PackBuilder builder;
+  builder.addTree( "tree", sElem );
+  ASSERT_TRUE( builder.write( ssPack ) );
+
+  PackManager manager;
+  ASSERT_TRUE( manager.open( ssPack ) );
+  expectSameTree( manager.getItem( "tree" ).root( ), sElem );
+
+  //
+  // 32 bit fields of the tree: nodes, lines, then firstLine, lineCount,
+  // firstChild, childCount of each node, then offset, size of each line
+  //
+  const size_t   NODES       = 0;
+  const size_t   ROOT_CHILD  = 2 + 2;
+  const size_t   CHILD_LINE  = 2 + 4;
+  const size_t   LINE_OFFSET = 2 + 8 + 2;
+  const uint32_t BIG         = 0x40000000;
+
+  ASSERT_TRUE ( manager.open( corruptTree( ssPack, NODES, BIG ) ) );
+  ASSERT_FALSE( manager.getItem( "tree" ).root( ).valid( ) );
+
+  ASSERT_TRUE ( manager.open( corruptTree( ssPack, NODES, 0 ) ) );
+  ASSERT_FALSE( manager.getItem( "tree" ).root( ).valid( ) );
+
+  ASSERT_TRUE ( manager.open( corruptTree( ssPack, ROOT_CHILD, 0 ) ) );
+  ASSERT_FALSE( manager.getItem( "tree" ).root( ).valid( ) );
+
+  ASSERT_TRUE ( manager.open( corruptTree( ssPack, CHILD_LINE, 2 ) ) );
+  ASSERT_FALSE( manager.getItem( "tree" ).root( ).valid( ) );
+
+  ASSERT_TRUE ( manager.open( corruptTree( ssPack, LINE_OFFSET, BIG ) ) );
+  ASSERT_FALSE( manager.getItem( "tree" ).root( ).valid( ) );
+
+  ASSERT_TRUE ( manager.open( corruptTree( ssPack, LINE_OFFSET, 1 ) ) );
+  ASSERT_TRUE ( manager.getItem( "tree" ).root( ).valid( ) );
+}
@@ -0,0 +1,108 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+// 
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : ProfilerTest.cpp
+//  Author  : Anthony Islas
+//  Purpose : Unit test for scoped profiler and trace export
+//  Group   : Components Unit Tests
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <sstream>
+#include <string>
+#include <thread>
+
+#include "gtest/gtest.h"
+
+#include "Profiler.hpp"
+
+using namespace components::timing;
+
+TEST( ComponentsTestsProfiler, ScopesExportAsTrace )
+{
+  Profiler::reset( );
+
+  {
+    ScopedTimer timer( "outer" );
+    ScopedTimer inner( "inner \"quoted\"" );
+  }
+
+  std::thread worker( []( ) { ScopedTimer timer( "worker" ); } );
+  worker.join( );
+
+  std::stringstream ss;
+  Profiler::writeChromeTrace( ss );
+  std::string ssTrace = ss.str( );
+
+  ASSERT_NE( ssTrace.find( "\"traceEvents\"" ),            std::string::npos );
+  ASSERT_NE( ssTrace.find( "\"name\":\"outer\"" ),         std::string::npos );
+  ASSERT_NE( ssTrace.find( "inner \\\"quoted\\\"" ),       std::string::npos );
+  ASSERT_NE( ssTrace.find( "\"name\":\"worker\"" ),        std::string::npos );
+  ASSERT_NE( ssTrace.find( "\"ph\":\"X\"" ),               std::string::npos );
+}
+
+TEST( ComponentsTestsProfiler, RingKeepsNewestScopes )
+{
+  Profiler::reset( );
+
+  for ( uint64_t i = 0; i < ProfileRing::RING_SIZE + 10; i++ )
+  {
+    Profiler::record( ( i < 10 ) ? "old" : "new", i, i + 1 );
+  }
+
+  std::stringstream ss;
+  Profiler::writeChromeTrace( ss );
+
+  ASSERT_EQ( ss.str( ).find( "\"old\"" ), std::string::npos );
+  ASSERT_NE( ss.str( ).find( "\"new\"" ), std::string::npos );
+}
+
+TEST( ComponentsTestsProfiler, RingsOfExitedThreadsReused )
+{
+  Profiler::reset( );
+
+  size_t uiRings = Profiler::rings( );
+
+  //
+  // Without a dump only a bounded number of rings are kept for exited threads
+  //
+  for ( int i = 0; i < 4 * COMPONENTS_PROFILE_RETIRED_RINGS; i++ )
+  {
+    std::thread worker( []( ) { Profiler::record( "worker", 1, 2 ); } );
+    worker.join( );
+  }
+
+  ASSERT_LE( Profiler::rings( ), uiRings + COMPONENTS_PROFILE_RETIRED_RINGS + 1 );
+
+  //
+  // After a dump every exited thread's ring is reused
+  //
+  std::stringstream ss;
+  Profiler::writeChromeTrace( ss );
+  ASSERT_NE( ss.str( ).find( "\"name\":\"worker\"" ), std::string::npos );
+
+  uiRings = Profiler::rings( );
+
+  for ( int i = 0; i < 4 * COMPONENTS_PROFILE_RETIRED_RINGS; i++ )
+  {
+    std::thread worker( []( ) { Profiler::record( "worker", 1, 2 ); } );
+    worker.join( );
+    Profiler::reset( );
+  }
+
+  ASSERT_EQ( Profiler::rings( ), uiRings );
+}
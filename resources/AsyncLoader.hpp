@@ -0,0 +1,262 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : AsyncLoader.hpp
+//  Author  : Anthony Islas
+//  Purpose : Deduplicated background loads feeding a Manager
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_ASYNC_LOADER_H__
+#define __RESOURCES_ASYNC_LOADER_H__
+
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Handle.hpp"
+#include "Index.hpp"
+#include "LoaderPool.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Loads run on a LoaderPool, finished items wait in a completion queue until
+// the owning thread adopts them with poll( ), so the manager itself is never
+// touched from a pool thread. Requests for a tag already in flight share its
+// future. Copying yields an empty loader, in-flight loads are not shared
+//
+template< typename Item, typename Tag, typename Index >
+class AsyncLoader
+{
+public:
+  typedef std::function< Item( const Tag& ) > Loader_t;
+  typedef std::shared_future< sHandle_t >     Future_t;
+
+  AsyncLoader( ) : pPool_( nullptr ) { }
+  AsyncLoader( const AsyncLoader& ) : pPool_( nullptr ) { }
+  AsyncLoader& operator=( const AsyncLoader& ) { return *this; }
+
+  void setLoader( Loader_t loader, LoaderPool& pool )
+  {
+    loader_ = std::move( loader );
+    pPool_  = &pool;
+  }
+
+  bool hasLoader( ) const { return static_cast< bool >( loader_ ); }
+
+  //
+  // Synchronous load on the calling thread
+  //
+  Item load( const Tag& tag ) const { return loader_( tag ); }
+
+  //
+  // Start or join a load, null future when no loader is set
+  //
+  Future_t request( const Tag& tag );
+
+  //
+  // Adopt finished loads, adopt( Tag&&, Item&& ) -> sHandle_t inserts the item
+  //
+  template< typename Adopt >
+  size_t poll( Adopt adopt );
+
+  size_t pending ( ) const                { return pendingIndex_.size( ); }
+  bool   inFlight( const Tag& tag ) const { return pendingIndex_.find( tag, keyOf( ) ) != INDEX_NPOS; }
+
+private:
+  typedef struct sPendingStructure
+  {
+    Tag                       tag;
+    std::promise< sHandle_t > promise;
+    Future_t                  future;
+  } sPending_t;
+
+  typedef struct sCompletionStructure
+  {
+    uint32_t                id;
+    std::unique_ptr< Item > pItem;
+    std::exception_ptr      error;
+  } sCompletion_t;
+
+  //
+  // Shared with pool jobs so loads finishing after the manager is gone are safe,
+  // created by the first request
+  //
+  typedef struct sDoneStructure
+  {
+    std::mutex                   mDone;
+    std::vector< sCompletion_t > vDone;
+  } sDone_t;
+
+  struct KeyOf
+  {
+    const std::vector< sPending_t >* pPending;
+    const Tag& operator()( uint32_t id ) const { return ( *pPending )[ id ].tag; }
+  };
+
+  KeyOf keyOf( ) const { KeyOf key; key.pPending = &vPending_; return key; }
+
+  Loader_t                   loader_;
+  LoaderPool*                pPool_;
+  std::shared_ptr< sDone_t > pDone_;
+
+  //
+  // In-flight loads, ids are stable and recycled through vPendingFree_
+  //
+  std::vector< sPending_t >  vPending_;
+  std::vector< uint32_t >    vPendingFree_;
+  Index                      pendingIndex_;
+};
+
+
+//**********************************************************************************
+//
+//  AsyncLoader::request
+//
+//  \brief Start a background load or join the one in flight
+//
+//  \param tag
+//
+//  \return future resolving to the item's handle once adopted by poll( )
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index >
+typename AsyncLoader< Item, Tag, Index >::Future_t
+AsyncLoader< Item, Tag, Index >::request( const Tag& tag )
+{
+  if ( !hasLoader( ) )
+  {
+    return Future_t( );
+  }
+
+  uint32_t id = pendingIndex_.find( tag, keyOf( ) );
+  if ( id != INDEX_NPOS )
+  {
+    return vPending_[ id ].future;
+  }
+
+  sPending_t sPending = { tag, std::promise< sHandle_t >( ), Future_t( ) };
+  sPending.future     = sPending.promise.get_future( ).share( );
+
+  if ( vPendingFree_.empty( ) )
+  {
+    id = static_cast< uint32_t >( vPending_.size( ) );
+    vPending_.push_back( std::move( sPending ) );
+  }
+  else
+  {
+    id = vPendingFree_.back( );
+    vPendingFree_.pop_back( );
+    vPending_[ id ] = std::move( sPending );
+  }
+  pendingIndex_.insert( tag, id, keyOf( ) );
+
+  if ( !pDone_ )
+  {
+    pDone_.reset( new sDone_t );
+  }
+
+  std::shared_ptr< sDone_t > pDone  = pDone_;
+  Loader_t                   loader = loader_;
+  Tag                        copy   = tag;
+
+  pPool_->submit( [ pDone, loader, copy, id ]( )
+    {
+      sCompletion_t sDone;
+      sDone.id = id;
+
+      try
+      {
+        sDone.pItem.reset( new Item( loader( copy ) ) );
+      }
+      catch ( ... )
+      {
+        sDone.error = std::current_exception( );
+      }
+
+      std::lock_guard< std::mutex > lock( pDone->mDone );
+      pDone->vDone.push_back( std::move( sDone ) );
+    } );
+
+  return vPending_[ id ].future;
+}
+
+//**********************************************************************************
+//
+//  AsyncLoader::poll
+//
+//  \brief Hand finished loads to the owner and resolve their futures
+//
+//  \param adopt inserts a loaded item, returns its handle
+//
+//  \return number of loads resolved
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index >
+template< typename Adopt >
+size_t AsyncLoader< Item, Tag, Index >::poll( Adopt adopt )
+{
+  std::vector< sCompletion_t > vDone;
+
+  if ( !pDone_ )
+  {
+    return 0;
+  }
+
+  {
+    std::lock_guard< std::mutex > lock( pDone_->mDone );
+    vDone.swap( pDone_->vDone );
+  }
+
+  for ( size_t i = 0; i < vDone.size( ); i++ )
+  {
+    sPending_t& sPending = vPending_[ vDone[ i ].id ];
+
+    pendingIndex_.erase( sPending.tag, keyOf( ) );
+    vPendingFree_.push_back( vDone[ i ].id );
+
+    if ( vDone[ i ].error )
+    {
+      sPending.promise.set_exception( vDone[ i ].error );
+    }
+    else
+    {
+      sPending.promise.set_value( adopt( Tag( sPending.tag ), std::move( *vDone[ i ].pItem ) ) );
+    }
+
+    sPending.promise = std::promise< sHandle_t >( );
+    sPending.future  = Future_t( );
+  }
+
+  return vDone.size( );
+}
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_ASYNC_LOADER_H__
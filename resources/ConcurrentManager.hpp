@@ -0,0 +1,517 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : ConcurrentManager.hpp
+//  Author  : Anthony Islas
+//  Purpose : Read-mostly resource manager for many threads, readers take no locks
+//            and writers publish new shard versions copy-on-write
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_CONCURRENT_MANAGER_H__
+#define __RESOURCES_CONCURRENT_MANAGER_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Epoch.hpp"
+#include "Manager.hpp"
+#include "Span.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Items are split over a fixed number of shards, each an immutable Manager.
+// The current version of every shard hangs off a single root so one atomic load
+// gives readers a consistent view of the whole table. Writers serialize on a
+// mutex, copy the affected shard and the ( small ) root, publish the new root
+// and retire the old versions to the epoch domain. Reads never block and never
+// write shared memory, so they scale with cores, at the cost of an O( n / shards )
+// copy per write
+//
+template< typename Item, typename Tag, typename Hash = std::hash< Tag > >
+class ConcurrentManager
+{
+public:
+  typedef Manager< Item, Tag, FlatHashIndex< Tag, Hash > > Shard_t;
+
+  explicit ConcurrentManager( size_t uiShards = 16 );
+  virtual ~ConcurrentManager( );
+
+  //
+  // Each call copies the tag's whole shard, O( n / shards ), so filling a
+  // manager one item at a time is quadratic. Use the batched forms for bulk
+  // writes
+  //
+  void addItem   ( Item item, Tag tag );
+  bool removeItem( const Tag& tag );
+
+  //
+  // Batched. Every affected shard is copied once and the whole batch becomes
+  // visible to readers at once, under a single new root
+  //
+  void   addItems   ( Span< std::pair< Tag, Item > > items );
+  size_t removeItems( Span< const Tag > tags );
+
+  //
+  // Copy the item out, lock-free
+  //
+  bool getItem( const Tag& tag, Item& rItem ) const;
+  bool hasItem( const Tag& tag ) const;
+
+  //
+  // Call fn( const Item& ) without copying, the reference is only valid inside fn
+  //
+  template< typename Fn >
+  bool visitItem( const Tag& tag, Fn fn ) const;
+
+  //
+  // Point-in-time copy of every item, consistent across shards while writers
+  // keep running
+  //
+  std::vector< Item > getItems( ) const;
+
+  size_t size( ) const;
+
+private:
+  typedef struct sRootStructure
+  {
+    std::vector< const Shard_t* > vShards;
+  } sRoot_t;
+
+  ConcurrentManager( const ConcurrentManager& ) = delete;
+  ConcurrentManager& operator=( const ConcurrentManager& ) = delete;
+
+  size_t shardOf( const Tag& tag ) const;
+  void   publish( const sRoot_t* pOld, size_t uiShard, Shard_t* pShard );
+  void   publish( const sRoot_t* pOld, const std::vector< Shard_t* >& vShards );
+
+  const size_t                  uiShards_;
+  std::atomic< const sRoot_t* > root_;
+  std::mutex                    mWriters_;
+  Hash                          hasher_;
+};
+
+
+//**********************************************************************************
+//
+//  ConcurrentManager::ConcurrentManager
+//
+//  \brief Empty concurrent manager
+//
+//  \param uiShards number of independently copied shards
+//
+//  \return ConcurrentManager
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+ConcurrentManager< Item, Tag, Hash >::ConcurrentManager( size_t uiShards ) :
+                                      uiShards_( uiShards == 0 ? 1 : uiShards )
+{
+  sRoot_t* pRoot = new sRoot_t;
+
+  for ( size_t i = 0; i < uiShards_; i++ )
+  {
+    pRoot->vShards.push_back( new Shard_t );
+  }
+
+  root_.store( pRoot, std::memory_order_release );
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::~ConcurrentManager
+//
+//  \brief DTOR, no reader may still be inside this manager
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+ConcurrentManager< Item, Tag, Hash >::~ConcurrentManager( )
+{
+  const sRoot_t* pRoot = root_.load( std::memory_order_acquire );
+
+  for ( size_t i = 0; i < pRoot->vShards.size( ); i++ )
+  {
+    delete pRoot->vShards[ i ];
+  }
+  delete pRoot;
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::addItem
+//
+//  \brief Add or replace an item
+//
+//  \param item
+//  \param tag
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+void ConcurrentManager< Item, Tag, Hash >::addItem( Item item, Tag tag )
+{
+  std::lock_guard< std::mutex > lock( mWriters_ );
+
+  const sRoot_t* pRoot   = root_.load( std::memory_order_relaxed );
+  size_t         uiShard = shardOf( tag );
+  Shard_t*       pShard  = new Shard_t( *pRoot->vShards[ uiShard ] );
+
+  pShard->addItem( std::move( item ), std::move( tag ) );
+  publish( pRoot, uiShard, pShard );
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::removeItem
+//
+//  \brief Remove an item
+//
+//  \param tag
+//
+//  \return true if an item was removed
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+bool ConcurrentManager< Item, Tag, Hash >::removeItem( const Tag& tag )
+{
+  std::lock_guard< std::mutex > lock( mWriters_ );
+
+  const sRoot_t* pRoot   = root_.load( std::memory_order_relaxed );
+  size_t         uiShard = shardOf( tag );
+
+  if ( !pRoot->vShards[ uiShard ]->hasItem( tag ) )
+  {
+    return false;
+  }
+
+  Shard_t* pShard = new Shard_t( *pRoot->vShards[ uiShard ] );
+  pShard->removeItem( tag );
+  publish( pRoot, uiShard, pShard );
+  return true;
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::addItems
+//
+//  \brief Add or replace many items, published together
+//
+//  \param items tag / item pairs, the items are moved from
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+void ConcurrentManager< Item, Tag, Hash >::addItems( Span< std::pair< Tag, Item > > items )
+{
+  if ( items.size( ) == 0 )
+  {
+    return;
+  }
+
+  std::lock_guard< std::mutex > lock( mWriters_ );
+
+  const sRoot_t*          pRoot = root_.load( std::memory_order_relaxed );
+  std::vector< Shard_t* > vShards( uiShards_, nullptr );
+
+  for ( size_t i = 0; i < items.size( ); i++ )
+  {
+    size_t uiShard = shardOf( items[ i ].first );
+
+    if ( vShards[ uiShard ] == nullptr )
+    {
+      vShards[ uiShard ] = new Shard_t( *pRoot->vShards[ uiShard ] );
+    }
+
+    vShards[ uiShard ]->addItem( std::move( items[ i ].second ), items[ i ].first );
+  }
+
+  publish( pRoot, vShards );
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::removeItems
+//
+//  \brief Remove many items, published together
+//
+//  \param tags
+//
+//  \return number of items removed
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+size_t ConcurrentManager< Item, Tag, Hash >::removeItems( Span< const Tag > tags )
+{
+  std::lock_guard< std::mutex > lock( mWriters_ );
+
+  const sRoot_t*          pRoot     = root_.load( std::memory_order_relaxed );
+  std::vector< Shard_t* > vShards( uiShards_, nullptr );
+  size_t                  uiRemoved = 0;
+
+  for ( size_t i = 0; i < tags.size( ); i++ )
+  {
+    size_t uiShard = shardOf( tags[ i ] );
+
+    if ( vShards[ uiShard ] == nullptr )
+    {
+      if ( !pRoot->vShards[ uiShard ]->hasItem( tags[ i ] ) )
+      {
+        continue;
+      }
+      vShards[ uiShard ] = new Shard_t( *pRoot->vShards[ uiShard ] );
+    }
+
+    if ( vShards[ uiShard ]->removeItem( tags[ i ] ) )
+    {
+      uiRemoved++;
+    }
+  }
+
+  if ( uiRemoved != 0 )
+  {
+    publish( pRoot, vShards );
+  }
+  return uiRemoved;
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::getItem
+//
+//  \brief Copy an item out
+//
+//  \param tag
+//  \param rItem receives the item
+//
+//  \return false if no item has the tag
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+bool ConcurrentManager< Item, Tag, Hash >::getItem( const Tag& tag, Item& rItem ) const
+{
+  return visitItem( tag, [ & ]( const Item& item ) { rItem = item; } );
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::hasItem
+//
+//  \brief Check for a tag
+//
+//  \param tag
+//
+//  \return true if an item has the tag
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+bool ConcurrentManager< Item, Tag, Hash >::hasItem( const Tag& tag ) const
+{
+  EpochGuard guard;
+  const sRoot_t* pRoot = root_.load( std::memory_order_acquire );
+  return pRoot->vShards[ shardOf( tag ) ]->hasItem( tag );
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::visitItem
+//
+//  \brief Inspect an item in place
+//
+//  \param tag
+//  \param fn called with the item inside the read-side critical section
+//
+//  \return false if no item has the tag
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+template< typename Fn >
+bool ConcurrentManager< Item, Tag, Hash >::visitItem( const Tag& tag, Fn fn ) const
+{
+  EpochGuard guard;
+
+  const sRoot_t* pRoot = root_.load( std::memory_order_acquire );
+  const Item*    pItem = pRoot->vShards[ shardOf( tag ) ]->getItem( tag );
+
+  if ( pItem == nullptr )
+  {
+    return false;
+  }
+
+  fn( *pItem );
+  return true;
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::getItems
+//
+//  \brief Snapshot every item
+//
+//  All shards are read from the same root, so the result reflects exactly the
+//  writes published before that root
+//
+//  \return vector of Items
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+std::vector< Item > ConcurrentManager< Item, Tag, Hash >::getItems( ) const
+{
+  EpochGuard guard;
+
+  const sRoot_t*      pRoot = root_.load( std::memory_order_acquire );
+  std::vector< Item > vItems;
+
+  for ( size_t i = 0; i < pRoot->vShards.size( ); i++ )
+  {
+    Span< const Item > items = pRoot->vShards[ i ]->getItems( );
+    vItems.insert( vItems.end( ), items.begin( ), items.end( ) );
+  }
+
+  return vItems;
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::size
+//
+//  \brief Number of items in the current version
+//
+//  \return count
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+size_t ConcurrentManager< Item, Tag, Hash >::size( ) const
+{
+  EpochGuard guard;
+
+  const sRoot_t* pRoot  = root_.load( std::memory_order_acquire );
+  size_t         uiSize = 0;
+
+  for ( size_t i = 0; i < pRoot->vShards.size( ); i++ )
+  {
+    uiSize += pRoot->vShards[ i ]->size( );
+  }
+
+  return uiSize;
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::shardOf
+//
+//  \brief Shard owning a tag
+//
+//  \param tag
+//
+//  The shard's FlatHashIndex places tags by the upper 32 bits of the same mixed
+//  hash, taking the shard from those would leave each index using a fraction of
+//  its slots in long probe runs, so the shard comes from bits 16 - 31
+//
+//  \return shard index
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+size_t ConcurrentManager< Item, Tag, Hash >::shardOf( const Tag& tag ) const
+{
+  uint64_t u64Hash = static_cast< uint64_t >( hasher_( tag ) ) * 0x9E3779B97F4A7C15ull;
+
+  return static_cast< size_t >( ( ( u64Hash >> 16 ) & 0xFFFF ) % uiShards_ );
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::publish
+//
+//  \brief Swap in a new version of one shard, writer lock held
+//
+//  \param pOld    root being replaced
+//  \param uiShard shard being replaced
+//  \param pShard  new shard version
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+void ConcurrentManager< Item, Tag, Hash >::publish( const sRoot_t* pOld,
+                                                     size_t         uiShard,
+                                                     Shard_t*       pShard )
+{
+  std::vector< Shard_t* > vShards( uiShards_, nullptr );
+
+  vShards[ uiShard ] = pShard;
+  publish( pOld, vShards );
+}
+
+//**********************************************************************************
+//
+//  ConcurrentManager::publish
+//
+//  \brief Swap in new versions of any number of shards under one root, writer
+//         lock held
+//
+//  \param pOld    root being replaced
+//  \param vShards new version of each shard, nullptr where unchanged
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Hash >
+void ConcurrentManager< Item, Tag, Hash >::publish( const sRoot_t*                 pOld,
+                                                     const std::vector< Shard_t* >& vShards )
+{
+  sRoot_t*                      pRoot = new sRoot_t( *pOld );
+  std::vector< const Shard_t* > vOldShards;
+
+  for ( size_t i = 0; i < vShards.size( ); i++ )
+  {
+    if ( vShards[ i ] != nullptr )
+    {
+      vOldShards.push_back( pRoot->vShards[ i ] );
+      pRoot->vShards[ i ] = vShards[ i ];
+    }
+  }
+
+  root_.store( pRoot, std::memory_order_seq_cst );
+
+  EpochDomain& domain = EpochDomain::instance( );
+
+  for ( size_t i = 0; i < vOldShards.size( ); i++ )
+  {
+    domain.retire( const_cast< Shard_t* >( vOldShards[ i ] ), &epochDelete< Shard_t > );
+  }
+  domain.retire( const_cast< sRoot_t* >( pOld ), &epochDelete< sRoot_t > );
+}
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_CONCURRENT_MANAGER_H__
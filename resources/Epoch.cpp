@@ -0,0 +1,314 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Epoch.cpp
+//  Author  : Anthony Islas
+//  Purpose : Epoch based reclamation implementation
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include "Epoch.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Gives the calling thread's record back to the domain when the thread exits
+//
+class EpochThreadExit
+{
+public:
+  EpochThreadExit( ) : pRecord( nullptr ) { }
+
+  ~EpochThreadExit( )
+  {
+    if ( pRecord != nullptr )
+    {
+      pRecord->depth = 0;
+      pRecord->epoch.store( 0, std::memory_order_release );
+      pRecord->inUse.store( false, std::memory_order_release );
+    }
+  }
+
+  EpochDomain::sRecord_t* pRecord;
+};
+
+namespace
+{
+
+thread_local EpochThreadExit t_threadExit;
+
+} // namespace
+
+//**********************************************************************************
+//
+//  EpochDomain::instance
+//
+//  \brief Process wide domain
+//
+//  \return domain
+//
+//**********************************************************************************
+EpochDomain& EpochDomain::instance( )
+{
+  static EpochDomain domain;
+  return domain;
+}
+
+//**********************************************************************************
+//
+//  EpochDomain::EpochDomain
+//
+//  \brief Empty domain starting at epoch 1 ( 0 marks an idle record )
+//
+//  \return EpochDomain
+//
+//**********************************************************************************
+EpochDomain::EpochDomain( ) :
+                          global_ ( 1       ),
+                          records_( nullptr )
+{ }
+
+//**********************************************************************************
+//
+//  EpochDomain::~EpochDomain
+//
+//  \brief DTOR, frees everything still retired and all records
+//
+//  \return none
+//
+//**********************************************************************************
+EpochDomain::~EpochDomain( )
+{
+  for ( size_t i = 0; i < vRetired_.size( ); i++ )
+  {
+    vRetired_[ i ].pfnDelete( vRetired_[ i ].pObject );
+  }
+  vRetired_.clear( );
+
+  sRecord_t* pRecord = records_.load( );
+  while ( pRecord != nullptr )
+  {
+    sRecord_t* pNext = pRecord->pNext;
+    delete pRecord;
+    pRecord = pNext;
+  }
+}
+
+//**********************************************************************************
+//
+//  EpochDomain::acquireRecord
+//
+//  \brief Claim a free record or push a new one onto the list
+//
+//  \return record owned by the calling thread
+//
+//**********************************************************************************
+EpochDomain::sRecord_t* EpochDomain::acquireRecord( )
+{
+  for ( sRecord_t* pRecord = records_.load( std::memory_order_acquire );
+        pRecord != nullptr;
+        pRecord = pRecord->pNext )
+  {
+    bool bFree = false;
+    if ( !pRecord->inUse.load( std::memory_order_relaxed ) &&
+          pRecord->inUse.compare_exchange_strong( bFree, true ) )
+    {
+      return pRecord;
+    }
+  }
+
+  sRecord_t* pRecord = new sRecord_t;
+  pRecord->epoch.store( 0 );
+  pRecord->inUse.store( true );
+  pRecord->depth = 0;
+  pRecord->pNext = records_.load( std::memory_order_relaxed );
+
+  while ( !records_.compare_exchange_weak( pRecord->pNext, pRecord ) )
+  { }
+
+  return pRecord;
+}
+
+//**********************************************************************************
+//
+//  EpochDomain::threadRecord
+//
+//  \brief The calling thread's record, claimed on first use
+//
+//  \return record
+//
+//**********************************************************************************
+EpochDomain::sRecord_t* EpochDomain::threadRecord( )
+{
+  if ( t_threadExit.pRecord == nullptr )
+  {
+    t_threadExit.pRecord = acquireRecord( );
+  }
+  return t_threadExit.pRecord;
+}
+
+//**********************************************************************************
+//
+//  EpochDomain::enter
+//
+//  \brief Begin a reader critical section
+//
+//  The announcement must be visible before any shared pointer is loaded, the
+//  fence pairs with the sequentially consistent epoch advance in retire( )
+//
+//  \return none
+//
+//**********************************************************************************
+void EpochDomain::enter( )
+{
+  sRecord_t* pRecord = threadRecord( );
+
+  if ( pRecord->depth++ == 0 )
+  {
+    pRecord->epoch.store( global_.load( std::memory_order_acquire ),
+                          std::memory_order_relaxed );
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+  }
+}
+
+//**********************************************************************************
+//
+//  EpochDomain::exit
+//
+//  \brief End a reader critical section
+//
+//  \return none
+//
+//**********************************************************************************
+void EpochDomain::exit( )
+{
+  sRecord_t* pRecord = threadRecord( );
+
+  if ( --pRecord->depth == 0 )
+  {
+    pRecord->epoch.store( 0, std::memory_order_release );
+  }
+}
+
+//**********************************************************************************
+//
+//  EpochDomain::retire
+//
+//  \brief Defer freeing an object that has just been unlinked
+//
+//  \param pObject   object no longer reachable by new readers
+//  \param pfnDelete frees pObject
+//
+//  Tags the object with the current epoch, advances the epoch and frees what it
+//  can. Readers that entered before the advance may still hold pObject
+//
+//  \return none
+//
+//**********************************************************************************
+void EpochDomain::retire( void* pObject, void ( *pfnDelete )( void* ) )
+{
+  std::lock_guard< std::mutex > lock( mRetired_ );
+
+  sRetired_t sRetired;
+  sRetired.pObject   = pObject;
+  sRetired.pfnDelete = pfnDelete;
+  sRetired.epoch     = global_.fetch_add( 1, std::memory_order_seq_cst );
+  vRetired_.push_back( sRetired );
+
+  collectLocked( );
+}
+
+//**********************************************************************************
+//
+//  EpochDomain::collect
+//
+//  \brief Free every retired object no reader can still see
+//
+//  \return none
+//
+//**********************************************************************************
+void EpochDomain::collect( )
+{
+  std::lock_guard< std::mutex > lock( mRetired_ );
+  collectLocked( );
+}
+
+//**********************************************************************************
+//
+//  EpochDomain::pending
+//
+//  \brief Number of retired objects waiting on readers
+//
+//  \return count
+//
+//**********************************************************************************
+size_t EpochDomain::pending( )
+{
+  std::lock_guard< std::mutex > lock( mRetired_ );
+  return vRetired_.size( );
+}
+
+//**********************************************************************************
+//
+//  EpochDomain::collectLocked
+//
+//  \brief collect( ) with mRetired_ held
+//
+//  An object retired in epoch E is safe once every active record entered in an
+//  epoch after E
+//
+//  \return none
+//
+//**********************************************************************************
+void EpochDomain::collectLocked( )
+{
+  uint64_t u64Oldest = global_.load( std::memory_order_seq_cst );
+
+  for ( sRecord_t* pRecord = records_.load( std::memory_order_acquire );
+        pRecord != nullptr;
+        pRecord = pRecord->pNext )
+  {
+    uint64_t u64Epoch = pRecord->epoch.load( std::memory_order_seq_cst );
+    if ( u64Epoch != 0 && u64Epoch < u64Oldest )
+    {
+      u64Oldest = u64Epoch;
+    }
+  }
+
+  size_t uiKept = 0;
+  for ( size_t i = 0; i < vRetired_.size( ); i++ )
+  {
+    if ( vRetired_[ i ].epoch < u64Oldest )
+    {
+      vRetired_[ i ].pfnDelete( vRetired_[ i ].pObject );
+    }
+    else
+    {
+      vRetired_[ uiKept++ ] = vRetired_[ i ];
+    }
+  }
+  vRetired_.resize( uiKept );
+}
+
+} // namespace resources
+
+} // namespace components
@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Epoch.hpp
+//  Author  : Anthony Islas
+//  Purpose : Epoch based reclamation, readers announce the epoch they entered in
+//            and writers only free retired memory once every reader has moved
+//            past the epoch it was retired in
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_EPOCH_H__
+#define __RESOURCES_EPOCH_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Process wide domain shared by every concurrent structure. Each thread owns a
+// record on a lock-free list, entering writes only that record so readers never
+// share a written cache line
+//
+class EpochDomain
+{
+public:
+  static EpochDomain& instance( );
+
+  //
+  // Reader critical section, may nest
+  //
+  void enter( );
+  void exit ( );
+
+  //
+  // Hand memory that is no longer reachable to the domain, it is freed with
+  // pfnDelete once no reader can still hold it
+  //
+  void retire ( void* pObject, void ( *pfnDelete )( void* ) );
+  void collect( );
+
+  size_t pending( );
+
+private:
+  EpochDomain( );
+  ~EpochDomain( );
+
+  typedef struct sRecordStructure
+  {
+    //
+    // Epoch entered in, 0 while outside any critical section
+    //
+    std::atomic< uint64_t >  epoch;
+    std::atomic< bool >      inUse;
+    uint32_t                 depth;
+    struct sRecordStructure* pNext;
+    char                     pad[ 64 ];
+  } sRecord_t;
+
+  typedef struct sRetiredStructure
+  {
+    void*    pObject;
+    void     ( *pfnDelete )( void* );
+    uint64_t epoch;
+  } sRetired_t;
+
+  sRecord_t* acquireRecord( );
+  sRecord_t* threadRecord ( );
+  void       collectLocked( );
+
+  std::atomic< uint64_t >   global_;
+  std::atomic< sRecord_t* > records_;
+
+  std::mutex                mRetired_;
+  std::vector< sRetired_t > vRetired_;
+
+  friend class EpochThreadExit;
+};
+
+//
+// RAII reader critical section
+//
+class EpochGuard
+{
+public:
+  EpochGuard( )  { EpochDomain::instance( ).enter( ); }
+  ~EpochGuard( ) { EpochDomain::instance( ).exit( );  }
+
+  EpochGuard( const EpochGuard& ) = delete;
+  EpochGuard& operator=( const EpochGuard& ) = delete;
+};
+
+//
+// Typed deleter for EpochDomain::retire
+//
+template< typename T >
+void epochDelete( void* pObject )
+{
+  delete static_cast< T* >( pObject );
+}
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_EPOCH_H__
@@ -0,0 +1,351 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Eviction.hpp
+//  Author  : Anthony Islas
+//  Purpose : Eviction policies for Manager, track per item byte cost and pick
+//            victims when a memory budget is exceeded
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_EVICTION_H__
+#define __RESOURCES_EVICTION_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Index.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Default byte cost of an item, pass your own functor to ClockEviction for
+// items owning heap memory
+//
+struct ItemCost
+{
+  template< typename Item >
+  size_t operator()( const Item& ) const { return sizeof( Item ); }
+};
+
+//
+// Keeps everything, compiles to nothing
+//
+class NoEviction
+{
+public:
+  template< typename Item >
+  void onInsert( uint32_t, const Item& ) { }
+  template< typename Item >
+  void onUpdate( uint32_t, const Item& ) { }
+
+  void onAccess( uint32_t )       { }
+  void onErase ( uint32_t )       { }
+  void onPin   ( uint32_t )       { }
+  void onUnpin ( uint32_t )       { }
+  void clear   ( )                { }
+
+  bool   overBudget( ) const { return false; }
+  size_t bytes     ( ) const { return 0;     }
+
+  template< typename Pinned >
+  uint32_t victim( Pinned ) { return INDEX_NPOS; }
+};
+
+//
+// CLOCK ( second chance ) approximation of LRU. Each item has a referenced bit
+// set on access, the hand sweeps a ring of the unpinned items clearing bits and
+// evicts the first one whose bit is already clear. Pinned items leave the ring,
+// so the hand never walks over them, O( 1 ) amortized per victim however many
+// items are pinned. While pinned items alone exceed the budget every unpinned
+// item is evicted, the manager shrinks to its pinned floor
+//
+template< typename Cost = ItemCost >
+class ClockEviction
+{
+public:
+  ClockEviction( ) : uiBudget_( 0 ), uiBytes_( 0 ), uiPinnedBytes_( 0 ), uiHand_( 0 ) { }
+
+  //
+  // Bytes allowed before victims are chosen, 0 for unlimited
+  //
+  void   setBudget( size_t uiBytes ) { uiBudget_ = uiBytes; }
+  size_t budget   ( ) const          { return uiBudget_;    }
+  size_t bytes    ( ) const          { return uiBytes_;     }
+  size_t pinned   ( ) const          { return uiPinnedBytes_; }
+
+  template< typename Item >
+  void onInsert( uint32_t dense, const Item& item );
+  template< typename Item >
+  void onUpdate( uint32_t dense, const Item& item );
+
+  void onAccess( uint32_t dense ) { vReferenced_[ dense ] = 1; }
+
+  //
+  // Mirrors the manager's swap with the last item
+  //
+  void onErase( uint32_t dense );
+  void clear  ( );
+
+  //
+  // First pin and last unpin of an item
+  //
+  void onPin  ( uint32_t dense ) { leaveRing( dense ); uiPinnedBytes_ += vCosts_[ dense ]; }
+  void onUnpin( uint32_t dense ) { enterRing( dense ); uiPinnedBytes_ -= vCosts_[ dense ]; }
+
+  bool overBudget( ) const { return uiBudget_ != 0 && uiBytes_ > uiBudget_; }
+
+  //
+  // Dense position to evict, INDEX_NPOS if everything is pinned
+  //
+  template< typename Pinned >
+  uint32_t victim( Pinned isPinned );
+
+private:
+  void enterRing( uint32_t dense );
+  void leaveRing( uint32_t dense );
+
+  size_t                         uiBudget_;
+  size_t                         uiBytes_;
+  size_t                         uiPinnedBytes_;
+  size_t                         uiHand_;
+  std::vector< uint8_t >         vReferenced_;
+  std::vector< size_t >          vCosts_;
+
+  //
+  // Dense positions of the unpinned items in hand order, and each item's place
+  // in it, INDEX_NPOS while pinned
+  //
+  std::vector< uint32_t >        vRing_;
+  std::vector< uint32_t >        vRingPos_;
+  Cost                           cost_;
+};
+
+
+//**********************************************************************************
+//
+//  ClockEviction::onInsert
+//
+//  \brief Track a new item, it starts referenced
+//
+//  \param dense position of the item
+//  \param item
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Cost >
+template< typename Item >
+void ClockEviction< Cost >::onInsert( uint32_t dense, const Item& item )
+{
+  size_t uiCost = cost_( item );
+
+  vReferenced_.resize( dense + 1, 0 );
+  vCosts_     .resize( dense + 1, 0 );
+  vRingPos_   .resize( dense + 1, INDEX_NPOS );
+
+  vReferenced_[ dense ] = 1;
+  vCosts_     [ dense ] = uiCost;
+  uiBytes_             += uiCost;
+  enterRing( dense );
+}
+
+//**********************************************************************************
+//
+//  ClockEviction::onUpdate
+//
+//  \brief Re-cost an item replaced in place
+//
+//  \param dense position of the item
+//  \param item  new item
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Cost >
+template< typename Item >
+void ClockEviction< Cost >::onUpdate( uint32_t dense, const Item& item )
+{
+  size_t uiCost = cost_( item );
+
+  if ( vRingPos_[ dense ] == INDEX_NPOS )
+  {
+    uiPinnedBytes_ = uiPinnedBytes_ - vCosts_[ dense ] + uiCost;
+  }
+
+  uiBytes_              = uiBytes_ - vCosts_[ dense ] + uiCost;
+  vCosts_     [ dense ] = uiCost;
+  vReferenced_[ dense ] = 1;
+}
+
+//**********************************************************************************
+//
+//  ClockEviction::onErase
+//
+//  \brief Forget an item, the last item takes its position
+//
+//  \param dense position of the removed item
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Cost >
+void ClockEviction< Cost >::onErase( uint32_t dense )
+{
+  uiBytes_ -= vCosts_[ dense ];
+
+  if ( vRingPos_[ dense ] == INDEX_NPOS )
+  {
+    uiPinnedBytes_ -= vCosts_[ dense ];
+  }
+  else
+  {
+    leaveRing( dense );
+  }
+
+  uint32_t last = static_cast< uint32_t >( vCosts_.size( ) - 1 );
+
+  if ( vRingPos_[ last ] != INDEX_NPOS )
+  {
+    vRing_[ vRingPos_[ last ] ] = dense;
+  }
+
+  vReferenced_[ dense ] = vReferenced_.back( );
+  vCosts_     [ dense ] = vCosts_.back( );
+  vRingPos_   [ dense ] = vRingPos_.back( );
+  vReferenced_.pop_back( );
+  vCosts_     .pop_back( );
+  vRingPos_   .pop_back( );
+}
+
+//**********************************************************************************
+//
+//  ClockEviction::clear
+//
+//  \brief Forget all items, keeps the budget
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Cost >
+void ClockEviction< Cost >::clear( )
+{
+  vReferenced_.clear( );
+  vCosts_     .clear( );
+  vRing_      .clear( );
+  vRingPos_   .clear( );
+  uiBytes_       = 0;
+  uiPinnedBytes_ = 0;
+  uiHand_        = 0;
+}
+
+//**********************************************************************************
+//
+//  ClockEviction::victim
+//
+//  \brief Advance the hand to the next item to evict
+//
+//  \param isPinned isPinned( dense ) true for items that must stay resident
+//
+//  Two full sweeps of the ring clear every referenced bit, so a victim is found
+//  unless the ring is empty or isPinned( ) holds for all of it. Manager reports
+//  every pin, including the item it keeps while evicting, through onPin( )
+//
+//  \return dense position or INDEX_NPOS
+//
+//**********************************************************************************
+template< typename Cost >
+template< typename Pinned >
+uint32_t ClockEviction< Cost >::victim( Pinned isPinned )
+{
+  size_t uiCount = vRing_.size( );
+
+  for ( size_t uiStep = 0; uiStep < 2 * uiCount; uiStep++ )
+  {
+    if ( uiHand_ >= uiCount )
+    {
+      uiHand_ = 0;
+    }
+
+    uint32_t dense = vRing_[ uiHand_++ ];
+
+    if ( isPinned( dense ) )
+    {
+      continue;
+    }
+    if ( vReferenced_[ dense ] )
+    {
+      vReferenced_[ dense ] = 0;
+      continue;
+    }
+    return dense;
+  }
+
+  return INDEX_NPOS;
+}
+
+//**********************************************************************************
+//
+//  ClockEviction::enterRing
+//
+//  \brief Put an unpinned item behind the hand
+//
+//  \param dense
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Cost >
+void ClockEviction< Cost >::enterRing( uint32_t dense )
+{
+  vRingPos_[ dense ] = static_cast< uint32_t >( vRing_.size( ) );
+  vRing_.push_back( dense );
+}
+
+//**********************************************************************************
+//
+//  ClockEviction::leaveRing
+//
+//  \brief Take an item out of the ring, the last one in it takes its place
+//
+//  \param dense
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Cost >
+void ClockEviction< Cost >::leaveRing( uint32_t dense )
+{
+  uint32_t pos  = vRingPos_[ dense ];
+  uint32_t back = vRing_.back( );
+
+  vRing_   [ pos   ] = back;
+  vRingPos_[ back  ] = pos;
+  vRingPos_[ dense ] = INDEX_NPOS;
+  vRing_.pop_back( );
+}
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_EVICTION_H__
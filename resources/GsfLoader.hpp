@@ -0,0 +1,81 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : GsfLoader.hpp
+//  Author  : Anthony Islas
+//  Purpose : Loader for .gsf backed resources, parses the file named by the tag
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_GSF_LOADER_H__
+#define __RESOURCES_GSF_LOADER_H__
+
+#include <stdexcept>
+#include <string>
+
+#include "Parser.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Manager< sParseElement_t, std::string >::setLoader( GsfLoader( ) ) loads by
+// path. A parser is built per call so loads on different pool threads share
+// nothing. Unreadable paths, reported by the parser's own open, throw so the
+// load fails rather than caching an empty element
+//
+class GsfLoader
+{
+public:
+  GsfLoader( const char cCommentChar    = '#',
+             const char cEscapeChar     = '\\',
+             const char cScopeStartChar = '{',
+             const char cScopeStopChar  = '}' ) :
+             cCommentChar_   ( cCommentChar    ),
+             cEscapeChar_    ( cEscapeChar     ),
+             cScopeStartChar_( cScopeStartChar ),
+             cScopeStopChar_ ( cScopeStopChar  )
+  { }
+
+  sParseElement_t operator()( const std::string& ssPath ) const
+  {
+    Parser          parser( cCommentChar_, cEscapeChar_, cScopeStartChar_, cScopeStopChar_ );
+    sParseElement_t sElem;
+
+    if ( !parser.ParseFile( ssPath, sElem ) )
+    {
+      throw std::runtime_error( "unable to open file \"" + ssPath + "\"" );
+    }
+
+    return sElem;
+  }
+
+private:
+  char cCommentChar_;
+  char cEscapeChar_;
+  char cScopeStartChar_;
+  char cScopeStopChar_;
+};
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_GSF_LOADER_H__
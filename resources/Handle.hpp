@@ -0,0 +1,54 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Handle.hpp
+//  Author  : Anthony Islas
+//  Purpose : Generational handle into a Manager slot map
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_HANDLE_H__
+#define __RESOURCES_HANDLE_H__
+
+#include <cstdint>
+
+#include "Index.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Generational handle into a Manager's slot map. Lookups through a handle skip
+// the tag index entirely, a handle whose item was removed is detected by its
+// generation no longer matching the slot
+//
+typedef struct sHandleStructure
+{
+  uint32_t index;
+  uint32_t generation;
+} sHandle_t;
+
+static const sHandle_t INVALID_HANDLE = { INDEX_NPOS, 0 };
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_HANDLE_H__
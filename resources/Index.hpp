@@ -0,0 +1,564 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Index.hpp
+//  Author  : Anthony Islas
+//  Purpose : Tag -> position index policies for Manager. The index only stores
+//            positions, tags are read back through a key accessor so they live
+//            once in the manager's contiguous storage
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_INDEX_H__
+#define __RESOURCES_INDEX_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Empty slot / not found
+//
+static const uint32_t INDEX_NPOS = 0xFFFFFFFFu;
+
+//
+// Hint that p is about to be read
+//
+#if defined( __GNUC__ ) || defined( __clang__ )
+#define RESOURCES_PREFETCH( p ) __builtin_prefetch( p )
+#else
+#define RESOURCES_PREFETCH( p ) ( ( void )( p ) )
+#endif
+
+//
+// Open addressing hash index, linear probing with backward shift deletion so
+// no tombstones build up under churn. Each slot keeps 32 bits of the hash to
+// skip most key comparisons and to rehash without touching the keys
+//
+template< typename Tag, typename Hash = std::hash< Tag > >
+class FlatHashIndex
+{
+public:
+  FlatHashIndex( ) : uiSize_( 0 ) { }
+
+  //
+  // All lookups take keyOf( uint32_t value ) -> const Tag&
+  //
+  template< typename KeyOf >
+  uint32_t find  ( const Tag& tag, KeyOf keyOf ) const { return find( tag, hashOf( tag ), keyOf ); }
+
+  //
+  // Batched lookups split find up, hash every tag and prefetch its home slot
+  // first, take the candidate value ( first stored hash match, no key compare )
+  // to prefetch what keyOf will touch, then probe once the lines are in flight
+  //
+  uint32_t hashOf   ( const Tag& tag ) const;
+  void     prefetch ( uint32_t u32Hash ) const;
+  uint32_t candidate( uint32_t u32Hash ) const;
+
+  template< typename KeyOf >
+  uint32_t find  ( const Tag& tag, uint32_t u32Hash, KeyOf keyOf ) const;
+
+  //
+  // Returns INDEX_NPOS if inserted, else the value already mapped to tag
+  //
+  template< typename KeyOf >
+  uint32_t insert( const Tag& tag, uint32_t value, KeyOf keyOf );
+
+  //
+  // Returns the removed value or INDEX_NPOS
+  //
+  template< typename KeyOf >
+  uint32_t erase ( const Tag& tag, KeyOf keyOf );
+
+  void   reserve( size_t uiCount );
+  void   clear  ( );
+  size_t size   ( ) const { return uiSize_; }
+
+private:
+  typedef struct sSlotStructure
+  {
+    uint32_t value;
+    uint32_t hash;
+  } sSlot_t;
+
+  void rehash( size_t uiSlots );
+
+  std::vector< sSlot_t > vSlots_;
+  size_t                 uiSize_;
+  Hash                   hasher_;
+};
+
+//
+// Sorted vector of values, binary searched. Cheaper than hashing for a handful
+// of tags and keeps no extra slots, but inserts and erases are O( n )
+//
+template< typename Tag, typename Less = std::less< Tag > >
+class SortedIndex
+{
+public:
+  template< typename KeyOf >
+  uint32_t find  ( const Tag& tag, KeyOf keyOf ) const;
+
+  //
+  // Same interface as FlatHashIndex for batched lookups, nothing to prefetch
+  //
+  uint32_t hashOf   ( const Tag& ) const { return 0;          }
+  void     prefetch ( uint32_t ) const   { }
+  uint32_t candidate( uint32_t ) const   { return INDEX_NPOS; }
+
+  template< typename KeyOf >
+  uint32_t find  ( const Tag& tag, uint32_t, KeyOf keyOf ) const { return find( tag, keyOf ); }
+
+  template< typename KeyOf >
+  uint32_t insert( const Tag& tag, uint32_t value, KeyOf keyOf );
+
+  template< typename KeyOf >
+  uint32_t erase ( const Tag& tag, KeyOf keyOf );
+
+  void   reserve( size_t uiCount ) { vValues_.reserve( uiCount ); }
+  void   clear  ( )                { vValues_.clear( );          }
+  size_t size   ( ) const          { return vValues_.size( );    }
+
+private:
+  template< typename KeyOf >
+  std::vector< uint32_t >::const_iterator lowerBound( const Tag& tag, KeyOf keyOf ) const;
+
+  std::vector< uint32_t > vValues_;
+  Less                    less_;
+};
+
+
+//**********************************************************************************
+//
+//  FlatHashIndex::hashOf
+//
+//  \brief Mixed 32 bit hash of a tag
+//
+//  \param tag
+//
+//  std::hash is the identity for integers, the multiply spreads sequential tags
+//  across the table
+//
+//  \return hash
+//
+//**********************************************************************************
+template< typename Tag, typename Hash >
+uint32_t FlatHashIndex< Tag, Hash >::hashOf( const Tag& tag ) const
+{
+  uint64_t u64Hash = static_cast< uint64_t >( hasher_( tag ) ) * 0x9E3779B97F4A7C15ull;
+  return static_cast< uint32_t >( u64Hash >> 32 );
+}
+
+//**********************************************************************************
+//
+//  FlatHashIndex::prefetch
+//
+//  \brief Start loading the home slot of a hash
+//
+//  \param u32Hash from hashOf( )
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Tag, typename Hash >
+void FlatHashIndex< Tag, Hash >::prefetch( uint32_t u32Hash ) const
+{
+  if ( !vSlots_.empty( ) )
+  {
+    RESOURCES_PREFETCH( &vSlots_[ u32Hash & ( vSlots_.size( ) - 1 ) ] );
+  }
+}
+
+//**********************************************************************************
+//
+//  FlatHashIndex::candidate
+//
+//  \brief Probe on the stored hashes only
+//
+//  \param u32Hash from hashOf( )
+//
+//  \return first value whose hash matches, likely but not surely the tag's,
+//          or INDEX_NPOS
+//
+//**********************************************************************************
+template< typename Tag, typename Hash >
+uint32_t FlatHashIndex< Tag, Hash >::candidate( uint32_t u32Hash ) const
+{
+  if ( uiSize_ == 0 )
+  {
+    return INDEX_NPOS;
+  }
+
+  size_t uiMask = vSlots_.size( ) - 1;
+
+  for ( size_t i = u32Hash & uiMask; ; i = ( i + 1 ) & uiMask )
+  {
+    const sSlot_t& sSlot = vSlots_[ i ];
+
+    if ( sSlot.value == INDEX_NPOS || sSlot.hash == u32Hash )
+    {
+      return sSlot.value;
+    }
+  }
+}
+
+//**********************************************************************************
+//
+//  FlatHashIndex::find
+//
+//  \brief Look up the value mapped to a tag
+//
+//  \param tag
+//  \param u32Hash hashOf( tag )
+//  \param keyOf   maps a stored value back to its tag
+//
+//  \return value or INDEX_NPOS
+//
+//**********************************************************************************
+template< typename Tag, typename Hash >
+template< typename KeyOf >
+uint32_t FlatHashIndex< Tag, Hash >::find( const Tag& tag, uint32_t u32Hash, KeyOf keyOf ) const
+{
+  if ( uiSize_ == 0 )
+  {
+    return INDEX_NPOS;
+  }
+
+  size_t uiMask = vSlots_.size( ) - 1;
+
+  for ( size_t i = u32Hash & uiMask; ; i = ( i + 1 ) & uiMask )
+  {
+    const sSlot_t& sSlot = vSlots_[ i ];
+
+    if ( sSlot.value == INDEX_NPOS )
+    {
+      return INDEX_NPOS;
+    }
+    if ( sSlot.hash == u32Hash && keyOf( sSlot.value ) == tag )
+    {
+      return sSlot.value;
+    }
+  }
+}
+
+//**********************************************************************************
+//
+//  FlatHashIndex::insert
+//
+//  \brief Map a tag to a value
+//
+//  \param tag
+//  \param value
+//  \param keyOf maps a stored value back to its tag
+//
+//  Grows at 3/4 load
+//
+//  \return INDEX_NPOS if inserted, otherwise the existing value ( unchanged )
+//
+//**********************************************************************************
+template< typename Tag, typename Hash >
+template< typename KeyOf >
+uint32_t FlatHashIndex< Tag, Hash >::insert( const Tag& tag, uint32_t value, KeyOf keyOf )
+{
+  if ( ( uiSize_ + 1 ) * 4 > vSlots_.size( ) * 3 )
+  {
+    rehash( std::max< size_t >( 16, vSlots_.size( ) * 2 ) );
+  }
+
+  size_t   uiMask  = vSlots_.size( ) - 1;
+  uint32_t u32Hash = hashOf( tag );
+
+  for ( size_t i = u32Hash & uiMask; ; i = ( i + 1 ) & uiMask )
+  {
+    sSlot_t& sSlot = vSlots_[ i ];
+
+    if ( sSlot.value == INDEX_NPOS )
+    {
+      sSlot.value = value;
+      sSlot.hash  = u32Hash;
+      uiSize_++;
+      return INDEX_NPOS;
+    }
+    if ( sSlot.hash == u32Hash && keyOf( sSlot.value ) == tag )
+    {
+      return sSlot.value;
+    }
+  }
+}
+
+//**********************************************************************************
+//
+//  FlatHashIndex::erase
+//
+//  \brief Remove a tag
+//
+//  \param tag
+//  \param keyOf maps a stored value back to its tag
+//
+//  Following entries of the probe run are shifted back into the hole when that
+//  does not move them before their home slot
+//
+//  \return removed value or INDEX_NPOS
+//
+//**********************************************************************************
+template< typename Tag, typename Hash >
+template< typename KeyOf >
+uint32_t FlatHashIndex< Tag, Hash >::erase( const Tag& tag, KeyOf keyOf )
+{
+  if ( uiSize_ == 0 )
+  {
+    return INDEX_NPOS;
+  }
+
+  size_t   uiMask  = vSlots_.size( ) - 1;
+  uint32_t u32Hash = hashOf( tag );
+  size_t   uiHole  = u32Hash & uiMask;
+
+  for ( ; ; uiHole = ( uiHole + 1 ) & uiMask )
+  {
+    const sSlot_t& sSlot = vSlots_[ uiHole ];
+
+    if ( sSlot.value == INDEX_NPOS )
+    {
+      return INDEX_NPOS;
+    }
+    if ( sSlot.hash == u32Hash && keyOf( sSlot.value ) == tag )
+    {
+      break;
+    }
+  }
+
+  uint32_t value = vSlots_[ uiHole ].value;
+
+  for ( size_t j = ( uiHole + 1 ) & uiMask; vSlots_[ j ].value != INDEX_NPOS; j = ( j + 1 ) & uiMask )
+  {
+    size_t uiHome = vSlots_[ j ].hash & uiMask;
+
+    if ( ( ( j - uiHome ) & uiMask ) >= ( ( j - uiHole ) & uiMask ) )
+    {
+      vSlots_[ uiHole ] = vSlots_[ j ];
+      uiHole            = j;
+    }
+  }
+
+  vSlots_[ uiHole ].value = INDEX_NPOS;
+  uiSize_--;
+  return value;
+}
+
+//**********************************************************************************
+//
+//  FlatHashIndex::reserve
+//
+//  \brief Size the table for uiCount tags without further growth
+//
+//  \param uiCount
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Tag, typename Hash >
+void FlatHashIndex< Tag, Hash >::reserve( size_t uiCount )
+{
+  size_t uiSlots = 16;
+  while ( uiSlots * 3 < uiCount * 4 )
+  {
+    uiSlots <<= 1;
+  }
+
+  if ( uiSlots > vSlots_.size( ) )
+  {
+    rehash( uiSlots );
+  }
+}
+
+//**********************************************************************************
+//
+//  FlatHashIndex::clear
+//
+//  \brief Remove all tags, keeps the table allocation
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Tag, typename Hash >
+void FlatHashIndex< Tag, Hash >::clear( )
+{
+  for ( size_t i = 0; i < vSlots_.size( ); i++ )
+  {
+    vSlots_[ i ].value = INDEX_NPOS;
+  }
+  uiSize_ = 0;
+}
+
+//**********************************************************************************
+//
+//  FlatHashIndex::rehash
+//
+//  \brief Move all entries into a table of uiSlots slots ( power of two )
+//
+//  \param uiSlots
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Tag, typename Hash >
+void FlatHashIndex< Tag, Hash >::rehash( size_t uiSlots )
+{
+  sSlot_t sEmpty;
+  sEmpty.value = INDEX_NPOS;
+  sEmpty.hash  = 0;
+
+  std::vector< sSlot_t > vOld( uiSlots, sEmpty );
+  vOld.swap( vSlots_ );
+
+  size_t uiMask = uiSlots - 1;
+
+  for ( size_t i = 0; i < vOld.size( ); i++ )
+  {
+    if ( vOld[ i ].value == INDEX_NPOS )
+    {
+      continue;
+    }
+
+    size_t j = vOld[ i ].hash & uiMask;
+    while ( vSlots_[ j ].value != INDEX_NPOS )
+    {
+      j = ( j + 1 ) & uiMask;
+    }
+    vSlots_[ j ] = vOld[ i ];
+  }
+}
+
+//**********************************************************************************
+//
+//  SortedIndex::lowerBound
+//
+//  \brief First value whose tag is not less than tag
+//
+//  \param tag
+//  \param keyOf maps a stored value back to its tag
+//
+//  \return iterator into the sorted values
+//
+//**********************************************************************************
+template< typename Tag, typename Less >
+template< typename KeyOf >
+std::vector< uint32_t >::const_iterator
+SortedIndex< Tag, Less >::lowerBound( const Tag& tag, KeyOf keyOf ) const
+{
+  const Less& less = less_;
+  return std::lower_bound( vValues_.begin( ), vValues_.end( ), tag,
+                           [ & ]( uint32_t value, const Tag& key )
+                           { return less( keyOf( value ), key ); } );
+}
+
+//**********************************************************************************
+//
+//  SortedIndex::find
+//
+//  \brief Look up the value mapped to a tag
+//
+//  \param tag
+//  \param keyOf maps a stored value back to its tag
+//
+//  \return value or INDEX_NPOS
+//
+//**********************************************************************************
+template< typename Tag, typename Less >
+template< typename KeyOf >
+uint32_t SortedIndex< Tag, Less >::find( const Tag& tag, KeyOf keyOf ) const
+{
+  std::vector< uint32_t >::const_iterator it = lowerBound( tag, keyOf );
+
+  if ( it == vValues_.end( ) || less_( tag, keyOf( *it ) ) )
+  {
+    return INDEX_NPOS;
+  }
+  return *it;
+}
+
+//**********************************************************************************
+//
+//  SortedIndex::insert
+//
+//  \brief Map a tag to a value
+//
+//  \param tag
+//  \param value
+//  \param keyOf maps a stored value back to its tag, need not resolve value yet
+//
+//  \return INDEX_NPOS if inserted, otherwise the existing value ( unchanged )
+//
+//**********************************************************************************
+template< typename Tag, typename Less >
+template< typename KeyOf >
+uint32_t SortedIndex< Tag, Less >::insert( const Tag& tag, uint32_t value, KeyOf keyOf )
+{
+  std::vector< uint32_t >::const_iterator it = lowerBound( tag, keyOf );
+
+  if ( it != vValues_.end( ) && !less_( tag, keyOf( *it ) ) )
+  {
+    return *it;
+  }
+
+  vValues_.insert( vValues_.begin( ) + ( it - vValues_.begin( ) ), value );
+  return INDEX_NPOS;
+}
+
+//**********************************************************************************
+//
+//  SortedIndex::erase
+//
+//  \brief Remove a tag
+//
+//  \param tag
+//  \param keyOf maps a stored value back to its tag
+//
+//  \return removed value or INDEX_NPOS
+//
+//**********************************************************************************
+template< typename Tag, typename Less >
+template< typename KeyOf >
+uint32_t SortedIndex< Tag, Less >::erase( const Tag& tag, KeyOf keyOf )
+{
+  std::vector< uint32_t >::const_iterator it = lowerBound( tag, keyOf );
+
+  if ( it == vValues_.end( ) || less_( tag, keyOf( *it ) ) )
+  {
+    return INDEX_NPOS;
+  }
+
+  uint32_t value = *it;
+  vValues_.erase( vValues_.begin( ) + ( it - vValues_.begin( ) ) );
+  return value;
+}
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_INDEX_H__
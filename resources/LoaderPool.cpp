@@ -0,0 +1,146 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : LoaderPool.cpp
+//  Author  : Anthony Islas
+//  Purpose : Background loader thread pool implementation
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include "LoaderPool.hpp"
+#include "Profiler.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//**********************************************************************************
+//
+//  LoaderPool::LoaderPool
+//
+//  \brief Start the loader threads
+//
+//  \param uiThreads number of threads, at least one
+//
+//  \return LoaderPool
+//
+//**********************************************************************************
+LoaderPool::LoaderPool( size_t uiThreads ) : bStopping_( false )
+{
+  for ( size_t i = 0; i < ( uiThreads == 0 ? 1 : uiThreads ); i++ )
+  {
+    vThreads_.push_back( std::thread( &LoaderPool::run, this ) );
+  }
+}
+
+//**********************************************************************************
+//
+//  LoaderPool::~LoaderPool
+//
+//  \brief DTOR, finishes every queued job then joins
+//
+//  \return none
+//
+//**********************************************************************************
+LoaderPool::~LoaderPool( )
+{
+  {
+    std::lock_guard< std::mutex > lock( mJobs_ );
+    bStopping_ = true;
+  }
+  cvJobs_.notify_all( );
+
+  for ( size_t i = 0; i < vThreads_.size( ); i++ )
+  {
+    vThreads_[ i ].join( );
+  }
+}
+
+//**********************************************************************************
+//
+//  LoaderPool::submit
+//
+//  \brief Queue a job
+//
+//  \param job run once on one of the pool threads
+//
+//  \return none
+//
+//**********************************************************************************
+void LoaderPool::submit( std::function< void( ) > job )
+{
+  {
+    std::lock_guard< std::mutex > lock( mJobs_ );
+    dJobs_.push_back( std::move( job ) );
+  }
+  cvJobs_.notify_one( );
+}
+
+//**********************************************************************************
+//
+//  LoaderPool::shared
+//
+//  \brief Process wide default pool
+//
+//  \return pool
+//
+//**********************************************************************************
+LoaderPool& LoaderPool::shared( )
+{
+  static LoaderPool pool;
+  return pool;
+}
+
+//**********************************************************************************
+//
+//  LoaderPool::run
+//
+//  \brief Pool thread, runs jobs until stopped and drained
+//
+//  \return none
+//
+//**********************************************************************************
+void LoaderPool::run( )
+{
+  for ( ;; )
+  {
+    std::function< void( ) > job;
+
+    {
+      std::unique_lock< std::mutex > lock( mJobs_ );
+      cvJobs_.wait( lock, [ this ]( ) { return bStopping_ || !dJobs_.empty( ); } );
+
+      if ( dJobs_.empty( ) )
+      {
+        return;
+      }
+
+      job = std::move( dJobs_.front( ) );
+      dJobs_.pop_front( );
+    }
+
+    PROFILE_SCOPE( "LoaderPool::job" );
+    job( );
+  }
+}
+
+} // namespace resources
+
+} // namespace components
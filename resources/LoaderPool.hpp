@@ -0,0 +1,75 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : LoaderPool.hpp
+//  Author  : Anthony Islas
+//  Purpose : Background threads running resource loads off the main thread
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_LOADER_POOL_H__
+#define __RESOURCES_LOADER_POOL_H__
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// FIFO of jobs drained by a fixed set of threads. Loads are I/O bound so jobs
+// are handed over under a plain mutex
+//
+class LoaderPool
+{
+public:
+  explicit LoaderPool( size_t uiThreads = 2 );
+  ~LoaderPool( );
+
+  void submit( std::function< void( ) > job );
+
+  //
+  // Pool used by managers that are not given one
+  //
+  static LoaderPool& shared( );
+
+private:
+  LoaderPool( const LoaderPool& ) = delete;
+  LoaderPool& operator=( const LoaderPool& ) = delete;
+
+  void run( );
+
+  std::vector< std::thread >             vThreads_;
+  std::deque< std::function< void( ) > > dJobs_;
+  std::mutex                             mJobs_;
+  std::condition_variable                cvJobs_;
+  bool                                   bStopping_;
+};
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_LOADER_POOL_H__
@@ -13,7 +13,8 @@
 //
 //  File    : Manager.hpp
 //  Author  : Anthony Islas
-//  Purpose : File Description
+//  Purpose : Generic tagged resource pool, items are kept contiguous and found
+//            through a pluggable flat index
 //  Group   : Resources
 //
 //  TODO    : Anthony Islas
@@ -24,29 +25,191 @@
 #ifndef __RESOURCES_MANAGER_H__
 #define __RESOURCES_MANAGER_H__
 
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "AsyncLoader.hpp"
+#include "Eviction.hpp"
+#include "Handle.hpp"
+#include "Index.hpp"
+#include "LoaderPool.hpp"
+#include "Span.hpp"
+#include "Stats.hpp"
+#include "Storage.hpp"
+
 namespace components
 {
 
 namespace resources
 {
 
-template< typename Item, typename Tag >
+//
+// Items and tags live in parallel dense vectors so sweeps over getItems( ) are
+// linear with no holes. A slot map sits between the outside world and the
+// dense position: Index maps a tag to a slot ( FlatHashIndex by default,
+// SortedIndex for small managers ) and each slot records its item's dense
+// position and generation. Removal swaps the last item into the hole, only the
+// moved item's slot is patched, which means raw pointers and spans are
+// invalidated by addItem / removeItem while handles stay valid. Eviction
+// ( NoEviction by default, ClockEviction for a byte budget ) drops unpinned
+// items when the budget is exceeded, handles of evicted items go stale.
+// Storage keeps items inline ( DenseStorage ) or, for large items churned
+// often, in a slab pool ( PooledStorage ) where they never move. Stats are off
+// until enableStats( ), disabled they cost one untaken branch per call, enabled
+// they add a few ns per lookup ( see ManagerStats )
+//
+template< typename Item,
+          typename Tag,
+          typename Index    = FlatHashIndex< Tag >,
+          typename Eviction = NoEviction,
+          typename Storage  = DenseStorage< Item > >
 class Manager
 {
 public:
   Manager();
   virtual ~Manager();
 
-  void addItem( Item item, Tag tag );
-  Item getItem( Tag tag );
+  sHandle_t addItem( Item item, Tag tag );
+
+  //
+  // Construct the item in place from args
+  //
+  template< typename... Args >
+  sHandle_t emplaceItem( Tag tag, Args&&... args );
+
+  bool      removeItem( const Tag& tag );
+  bool      removeItem( sHandle_t handle );
+
+  //
+  // Cold path, hash / compare the tag. The non-const lookup loads a missing
+  // item through the loader, if one is set
+  //
+  Item*       getItem( const Tag& tag );
+  const Item* getItem( const Tag& tag ) const;
+  bool        hasItem( const Tag& tag ) const { return find( tag ) != INDEX_NPOS; }
+  sHandle_t   getHandle( const Tag& tag ) const;
+
+  //
+  // Hot path, bounds and generation check then index
+  //
+  Item*       getItem( sHandle_t handle );
+  const Item* getItem( sHandle_t handle ) const;
+  bool        isValid( sHandle_t handle ) const;
+
+  typename Storage::Range_t      getItems( )       { return items_.view( );              }
+  typename Storage::ConstRange_t getItems( ) const { return items_.view( );              }
+  Span< const Tag >              getTags ( ) const { return Span< const Tag >( tags_ ); }
+
+  //
+  // Batched. addItems moves the items out of the pairs and grows everything
+  // once, getItems resolves many tags with their memory loads overlapped
+  //
+  void   addItems( Span< std::pair< Tag, Item > > items );
+  size_t getItems( Span< const Tag > tags, Span< Item* > items );
+
+  size_t size   ( ) const { return items_.size( ); }
+  void   reserve( size_t uiCount );
+  void   clear  ( );
+
+  //
+  // Background loading. Items requested through getItemAsync( ) are loaded on
+  // the pool and only inserted when the owning thread calls pollLoads( ), so
+  // the manager stays single threaded. Concurrent requests for one tag share a
+  // single load
+  //
+  typedef typename AsyncLoader< Item, Tag, Index >::Loader_t Loader_t;
+
+  void                            setLoader   ( Loader_t    loader,
+                                                LoaderPool& pool = LoaderPool::shared( ) );
+  std::shared_future< sHandle_t > getItemAsync( const Tag& tag );
+  size_t                          pollLoads   ( );
+  size_t                          pendingLoads( ) const { return loads_.pending( ); }
+
+  //
+  // Memory budget. Configure through eviction( ), e.g. setBudget( ) on a
+  // ClockEviction. Pins nest, a pinned item is never evicted
+  //
+  Eviction&       eviction( )       { return eviction_; }
+  const Eviction& eviction( ) const { return eviction_; }
+
+  bool   pin     ( sHandle_t handle );
+  bool   unpin   ( sHandle_t handle );
+  bool   isPinned( sHandle_t handle ) const;
+  size_t evict   ( );
+
+  //
+  // Lookup and memory statistics, listed in StatsRegistry under ssName until
+  // disabled or the manager is destroyed. Bytes are the eviction policy's
+  // estimate when it keeps one, sizeof( Item ) per item otherwise
+  //
+  void                enableStats ( const std::string& ssName );
+  void                disableStats( ) { stats_.reset( ); }
+  const ManagerStats* stats       ( ) const { return stats_.get( ); }
 
-  std::vector< Items > getItems( );
-  
 protected:
 
-  std::map< Tag, Item > items_;
+  typedef struct sSlotStructure
+  {
+    //
+    // Dense position while live, next free slot while free
+    //
+    uint32_t dense;
+    uint32_t generation;
+  } sSlot_t;
+
+  //
+  // Maps a slot back to its tag for the index
+  //
+  struct KeyOf
+  {
+    const Manager* pManager;
+    const Tag& operator()( uint32_t slot ) const
+    {
+      return pManager->tags_[ pManager->slots_[ slot ].dense ];
+    }
+  };
+
+  KeyOf    keyOf( ) const { KeyOf key; key.pManager = this; return key; }
+  uint32_t find ( const Tag& tag ) const { return index_.find( tag, keyOf( ) ); }
+
+  uint32_t  allocateSlot( );
+  void      releaseSlot ( uint32_t slot );
+  void      eraseSlot   ( uint32_t slot );
+  sHandle_t handleOf    ( uint32_t slot ) const;
+
+  //
+  // Tags resolved per pass of a batched lookup, and the size below which the
+  // manager is assumed cache resident and lookups are not pipelined
+  //
+  static const size_t LOOKUP_BATCH    = 32;
+  static const size_t LOOKUP_PIPELINE = 65536;
+  size_t    evictOver   ( uint32_t keep );
+
+  uint64_t  statsStart  ( ) const { return stats_.get( ) ? stats_.get( )->startLookup( ) : 0; }
+  void      statsEnd    ( bool bHit, uint64_t u64Start ) const;
+  void      statsCount  ( eStatsCounter_t eCounter, uint64_t u64Count ) const;
+  void      statsResize ( ) const;
+
+  Storage                 items_;
+  std::vector< Tag >      tags_;
+  std::vector< uint32_t > denseToSlot_;
+  std::vector< sSlot_t >  slots_;
+  uint32_t                freeSlot_;
+  Index                   index_;
 
+  //
+  // Pin count per dense position
+  //
+  std::vector< uint32_t > pins_;
+  Eviction                eviction_;
 
+  AsyncLoader< Item, Tag, Index > loads_;
+  StatsHolder                     stats_;
 };
 
 
@@ -59,10 +222,10 @@ protected:
 //  \return Manager of type Item and Tag
 //
 //**********************************************************************************
-template< typename Item, typename Tag >
-Manager::Manager( )
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+Manager< Item, Tag, Index, Eviction, Storage >::Manager( ) : freeSlot_( INDEX_NPOS )
 {
-  items_.clear( );
+  clear( );
 }
 
 //**********************************************************************************
@@ -74,11 +237,11 @@ Manager::Manager( )
 //  \return none
 //
 //**********************************************************************************
-template< typename Item, typename Tag >
-Manager::~Manager( )
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+Manager< Item, Tag, Index, Eviction, Storage >::~Manager( )
 {
 
-  items_.clear( );
+  clear( );
 
 }
 
@@ -91,17 +254,118 @@ Manager::~Manager( )
 //  \param item 
 //  \param tag 
 // 
-//  Places the item into a resource pool with an associated tag to reference later
+//  Places the item into a resource pool with an associated tag to reference later,
+//  an item already under tag is replaced and keeps its handle
 //
-//  \return none
+//  \return handle to the item
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+sHandle_t Manager< Item, Tag, Index, Eviction, Storage >::addItem( Item item, Tag tag )
+{
+  return emplaceItem( std::move( tag ), std::move( item ) );
+}
+
+//**********************************************************************************
+//
+//  Manager::emplaceItem
+//
+//  \brief Construct an item in the resource pool
+// 
+//  \param tag 
+//  \param args forwarded to Item's constructor
+// 
+//  Same as addItem without building a temporary Item, with PooledStorage the
+//  item is built directly in its pool block
+//
+//  \return handle to the item
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+template< typename... Args >
+sHandle_t Manager< Item, Tag, Index, Eviction, Storage >::emplaceItem( Tag tag, Args&&... args )
+{
+  uint32_t slot = allocateSlot( );
+
+  tags_.push_back( std::move( tag ) );
+  uint32_t existing = index_.insert( tags_.back( ), slot, keyOf( ) );
+
+  if ( existing != INDEX_NPOS )
+  {
+    uint32_t dense = slots_[ existing ].dense;
+
+    tags_.pop_back( );
+    releaseSlot( slot );
+    items_.replace( dense, std::forward< Args >( args )... );
+    eviction_.onUpdate( dense, items_[ dense ] );
+    statsCount( STATS_INSERTS, 1 );
+    evictOver( existing );
+    statsResize( );
+    return handleOf( existing );
+  }
+
+  items_      .emplace_back( std::forward< Args >( args )... );
+  denseToSlot_.push_back( slot );
+  pins_       .push_back( 0 );
+  eviction_.onInsert( slots_[ slot ].dense, items_.back( ) );
+  statsCount( STATS_INSERTS, 1 );
+  evictOver( slot );
+  statsResize( );
+  return handleOf( slot );
+}
+
+//**********************************************************************************
+//
+//  Manager::removeItem
+//
+//  \brief Remove an item from the resource pool
+// 
+//  \param tag 
+// 
+//  The last item is moved into the freed position
+//
+//  \return true if an item was removed
 //
 //**********************************************************************************
-template< typename Item, typename Tag >
-Manager::addItem( Item item, Tag tag )
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+bool Manager< Item, Tag, Index, Eviction, Storage >::removeItem( const Tag& tag )
 {
+  uint32_t slot = index_.erase( tag, keyOf( ) );
+
+  if ( slot == INDEX_NPOS )
+  {
+    return false;
+  }
 
+  eraseSlot( slot );
+  statsResize( );
+  return true;
 }
 
+//**********************************************************************************
+//
+//  Manager::removeItem
+//
+//  \brief Remove an item from the resource pool by handle
+// 
+//  \param handle 
+//
+//  \return true if an item was removed, false for a stale handle
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+bool Manager< Item, Tag, Index, Eviction, Storage >::removeItem( sHandle_t handle )
+{
+  if ( !isValid( handle ) )
+  {
+    return false;
+  }
+
+  index_.erase( tags_[ slots_[ handle.index ].dense ], keyOf( ) );
+  eraseSlot( handle.index );
+  statsResize( );
+  return true;
+}
 
 //**********************************************************************************
 //
@@ -111,40 +375,732 @@ Manager::addItem( Item item, Tag tag )
 // 
 //  \param tag 
 // 
-//  Retrieves an item from the resource pool with the associated tag
+//  Retrieves an item from the resource pool with the associated tag. A missing
+//  item ( never added or evicted ) is loaded synchronously when a loader is set
+//  and no background load of it is in flight
 //
-//  \return Item
+//  \return Item, null if no item has the tag
 //
 //**********************************************************************************
-template< typename Item, typename Tag >
-Manager::getItem( Tag tag )
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+Item* Manager< Item, Tag, Index, Eviction, Storage >::getItem( const Tag& tag )
+{
+  uint64_t u64Start = statsStart( );
+  uint32_t slot     = find( tag );
+
+  statsEnd( slot != INDEX_NPOS, u64Start );
+
+  if ( slot == INDEX_NPOS )
+  {
+    if ( !loads_.hasLoader( ) || loads_.inFlight( tag ) )
+    {
+      return nullptr;
+    }
+
+    slot = addItem( loads_.load( tag ), tag ).index;
+  }
+
+  uint32_t dense = slots_[ slot ].dense;
+  eviction_.onAccess( dense );
+  return &items_[ dense ];
+}
+
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+const Item* Manager< Item, Tag, Index, Eviction, Storage >::getItem( const Tag& tag ) const
 {
+  uint64_t u64Start = statsStart( );
+  uint32_t slot     = find( tag );
 
+  statsEnd( slot != INDEX_NPOS, u64Start );
+  return ( slot == INDEX_NPOS ) ? nullptr : &items_[ slots_[ slot ].dense ];
 }
 
 //**********************************************************************************
 //
-//  Manager::getItems
+//  Manager::getHandle
 //
-//  \brief Get all items in the resource pool
+//  \brief Resolve a tag once so later lookups can skip the index
 // 
+//  \param tag 
+//
+//  \return handle, INVALID_HANDLE if no item has the tag
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+sHandle_t Manager< Item, Tag, Index, Eviction, Storage >::getHandle( const Tag& tag ) const
+{
+  uint32_t slot = find( tag );
+  return ( slot == INDEX_NPOS ) ? INVALID_HANDLE : handleOf( slot );
+}
+
+//**********************************************************************************
+//
+//  Manager::getItem
+//
+//  \brief Get an item from the resource pool by handle
 // 
-//  Get all items in the resource pool
+//  \param handle 
+//
+//  \return Item, null if the handle is stale
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+Item* Manager< Item, Tag, Index, Eviction, Storage >::getItem( sHandle_t handle )
+{
+  statsCount( STATS_LOOKUPS, 1 );
+
+  if ( !isValid( handle ) )
+  {
+    statsCount( STATS_MISSES, 1 );
+    return nullptr;
+  }
+
+  uint32_t dense = slots_[ handle.index ].dense;
+  eviction_.onAccess( dense );
+  return &items_[ dense ];
+}
+
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+const Item* Manager< Item, Tag, Index, Eviction, Storage >::getItem( sHandle_t handle ) const
+{
+  statsCount( STATS_LOOKUPS, 1 );
+
+  if ( !isValid( handle ) )
+  {
+    statsCount( STATS_MISSES, 1 );
+    return nullptr;
+  }
+
+  return &items_[ slots_[ handle.index ].dense ];
+}
+
+//**********************************************************************************
+//
+//  Manager::isValid
+//
+//  \brief Check a handle still refers to a live item
+// 
+//  \param handle 
+//
+//  \return true if the handle's item has not been removed
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+bool Manager< Item, Tag, Index, Eviction, Storage >::isValid( sHandle_t handle ) const
+{
+  return handle.index < slots_.size( ) &&
+         slots_[ handle.index ].generation == handle.generation;
+}
+
+//**********************************************************************************
+//
+//  Manager::addItems
+//
+//  \brief Add many items at once
+//
+//  \param items tag / item pairs, both are moved from
+//
+//  Sizes the index and storage for all of them up front so the batch causes at
+//  most one rehash
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::addItems( Span< std::pair< Tag, Item > > items )
+{
+  reserve( size( ) + items.size( ) );
+
+  for ( size_t i = 0; i < items.size( ); i++ )
+  {
+    emplaceItem( std::move( items[ i ].first ), std::move( items[ i ].second ) );
+  }
+}
+
+//**********************************************************************************
+//
+//  Manager::getItems
+//
+//  \brief Look up many tags at once
+//
+//  \param tags
+//  \param items receives one pointer per tag, null for tags with no item
+//
+//  Works through LOOKUP_BATCH tags at a time in passes, each prefetching what
+//  the next one reads: the index slots, the slot map entries of the candidates,
+//  their tags, then the full probe and resolve. The cache misses of a batch
+//  overlap instead of forming one chain per tag. Small managers skip the passes,
+//  their lines are already cached. Missing items are not loaded
+//
+//  \return number of tags found
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+size_t Manager< Item, Tag, Index, Eviction, Storage >::getItems( Span< const Tag > tags,
+                                                                 Span< Item* >     items )
+{
+  uint32_t aHash[ LOOKUP_BATCH ];
+  uint32_t aSlot[ LOOKUP_BATCH ];
+  size_t   uiFound = 0;
+
+  if ( items.size( ) < tags.size( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " output smaller than tags"
+                              << std::endl;
+    return 0;
+  }
+
+  if ( size( ) < LOOKUP_PIPELINE )
+  {
+    for ( size_t i = 0; i < tags.size( ); i++ )
+    {
+      uint32_t slot = find( tags[ i ] );
+
+      if ( slot == INDEX_NPOS )
+      {
+        items[ i ] = nullptr;
+        continue;
+      }
+
+      uint32_t dense = slots_[ slot ].dense;
+      eviction_.onAccess( dense );
+      items[ i ] = &items_[ dense ];
+      uiFound++;
+    }
+
+    statsCount( STATS_LOOKUPS, tags.size( ) );
+    statsCount( STATS_MISSES,  tags.size( ) - uiFound );
+    return uiFound;
+  }
+
+  for ( size_t uiBase = 0; uiBase < tags.size( ); uiBase += LOOKUP_BATCH )
+  {
+    size_t uiCount = tags.size( ) - uiBase;
+    if ( uiCount > LOOKUP_BATCH )
+    {
+      uiCount = LOOKUP_BATCH;
+    }
+
+    for ( size_t i = 0; i < uiCount; i++ )
+    {
+      aHash[ i ] = index_.hashOf( tags[ uiBase + i ] );
+      index_.prefetch( aHash[ i ] );
+    }
+
+    for ( size_t i = 0; i < uiCount; i++ )
+    {
+      aSlot[ i ] = index_.candidate( aHash[ i ] );
+      if ( aSlot[ i ] != INDEX_NPOS )
+      {
+        RESOURCES_PREFETCH( &slots_[ aSlot[ i ] ] );
+      }
+    }
+
+    for ( size_t i = 0; i < uiCount; i++ )
+    {
+      if ( aSlot[ i ] != INDEX_NPOS )
+      {
+        RESOURCES_PREFETCH( &tags_[ slots_[ aSlot[ i ] ].dense ] );
+      }
+    }
+
+    for ( size_t i = 0; i < uiCount; i++ )
+    {
+      aSlot[ i ] = index_.find( tags[ uiBase + i ], aHash[ i ], keyOf( ) );
+
+      if ( aSlot[ i ] == INDEX_NPOS )
+      {
+        items[ uiBase + i ] = nullptr;
+        continue;
+      }
+
+      uint32_t dense = slots_[ aSlot[ i ] ].dense;
+      eviction_.onAccess( dense );
+      items[ uiBase + i ] = &items_[ dense ];
+      uiFound++;
+    }
+  }
+
+  statsCount( STATS_LOOKUPS, tags.size( ) );
+  statsCount( STATS_MISSES,  tags.size( ) - uiFound );
+  return uiFound;
+}
+
+//**********************************************************************************
+//
+//  Manager::reserve
+//
+//  \brief Make room for uiCount items
+// 
+//  \param uiCount
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::reserve( size_t uiCount )
+{
+  items_      .reserve( uiCount );
+  tags_       .reserve( uiCount );
+  denseToSlot_.reserve( uiCount );
+  pins_       .reserve( uiCount );
+  slots_      .reserve( uiCount );
+  index_      .reserve( uiCount );
+}
+
+//**********************************************************************************
+//
+//  Manager::clear
+//
+//  \brief Remove all items
+//
+//  Slots are kept and retired so handles issued before the clear stay stale
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::clear( )
+{
+  for ( size_t i = 0; i < denseToSlot_.size( ); i++ )
+  {
+    releaseSlot( denseToSlot_[ i ] );
+  }
+
+  items_      .clear( );
+  tags_       .clear( );
+  denseToSlot_.clear( );
+  pins_       .clear( );
+  index_      .clear( );
+  eviction_   .clear( );
+  statsResize( );
+}
+
+//**********************************************************************************
+//
+//  Manager::setLoader
+//
+//  \brief Register how items of this manager are loaded
+//
+//  \param loader called with a tag on a pool thread, returns the item
+//  \param pool   threads to load on
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::setLoader( Loader_t loader, LoaderPool& pool )
+{
+  loads_.setLoader( std::move( loader ), pool );
+}
+
+//**********************************************************************************
+//
+//  Manager::getItemAsync
+//
+//  \brief Get an item, loading it in the background if it is not resident
+//
+//  \param tag
+//
+//  Never blocks, resident items resolve immediately. The future of a load only
+//  becomes ready in a later pollLoads( ) and carries any exception the loader
+//  threw
+//
+//  \return future of the item's handle, invalid future if there is no loader
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+std::shared_future< sHandle_t > Manager< Item, Tag, Index, Eviction, Storage >::getItemAsync( const Tag& tag )
+{
+  uint32_t slot = find( tag );
+
+  if ( slot != INDEX_NPOS )
+  {
+    std::promise< sHandle_t > promise;
+    promise.set_value( handleOf( slot ) );
+    return promise.get_future( ).share( );
+  }
+
+  if ( !loads_.hasLoader( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " no loader set for async request"
+                              << std::endl;
+  }
+
+  return loads_.request( tag );
+}
+
+//**********************************************************************************
+//
+//  Manager::pollLoads
+//
+//  \brief Insert finished background loads and resolve their futures
+//
+//  Call from the thread that owns the manager, once per frame or tick
+//
+//  \return number of loads resolved
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+size_t Manager< Item, Tag, Index, Eviction, Storage >::pollLoads( )
+{
+  return loads_.poll( [ this ]( Tag&& tag, Item&& item )
+                      { return addItem( std::move( item ), std::move( tag ) ); } );
+}
+
+//**********************************************************************************
+//
+//  Manager::pin
+//
+//  \brief Keep an item resident until a matching unpin
+//
+//  \param handle
+//
+//  \return false for a stale handle
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+bool Manager< Item, Tag, Index, Eviction, Storage >::pin( sHandle_t handle )
+{
+  if ( !isValid( handle ) )
+  {
+    return false;
+  }
+
+  uint32_t dense = slots_[ handle.index ].dense;
+
+  if ( pins_[ dense ]++ == 0 )
+  {
+    eviction_.onPin( dense );
+  }
+  return true;
+}
+
+//**********************************************************************************
+//
+//  Manager::unpin
+//
+//  \brief Release one pin, the item becomes evictable again with the last one
+//
+//  \param handle
+//
+//  \return false for a stale or unpinned handle
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+bool Manager< Item, Tag, Index, Eviction, Storage >::unpin( sHandle_t handle )
+{
+  if ( !isValid( handle ) || pins_[ slots_[ handle.index ].dense ] == 0 )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " unpin without a matching pin"
+                              << std::endl;
+    return false;
+  }
+
+  uint32_t dense = slots_[ handle.index ].dense;
+
+  if ( --pins_[ dense ] == 0 )
+  {
+    eviction_.onUnpin( dense );
+  }
+  return true;
+}
+
+//**********************************************************************************
+//
+//  Manager::isPinned
+//
+//  \brief Check for outstanding pins
+//
+//  \param handle
+//
+//  \return true if the handle's item is live and pinned
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+bool Manager< Item, Tag, Index, Eviction, Storage >::isPinned( sHandle_t handle ) const
+{
+  return isValid( handle ) && pins_[ slots_[ handle.index ].dense ] != 0;
+}
+
+//**********************************************************************************
+//
+//  Manager::evict
+//
+//  \brief Evict until back within budget, e.g. after lowering it
+//
+//  \return number of items evicted
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+size_t Manager< Item, Tag, Index, Eviction, Storage >::evict( )
+{
+  size_t uiEvicted = evictOver( INDEX_NPOS );
+  statsResize( );
+  return uiEvicted;
+}
+
+//**********************************************************************************
+//
+//  Manager::allocateSlot
+//
+//  \brief Take a slot off the free list, or grow the slot map
+//
+//  The slot points at the next dense position
+//
+//  \return slot
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+uint32_t Manager< Item, Tag, Index, Eviction, Storage >::allocateSlot( )
+{
+  uint32_t slot = freeSlot_;
+
+  if ( slot == INDEX_NPOS )
+  {
+    sSlot_t sSlot;
+    sSlot.generation = 1;
+    slot             = static_cast< uint32_t >( slots_.size( ) );
+    slots_.push_back( sSlot );
+  }
+  else
+  {
+    freeSlot_ = slots_[ slot ].dense;
+  }
+
+  slots_[ slot ].dense = static_cast< uint32_t >( items_.size( ) );
+  return slot;
+}
+
+//**********************************************************************************
+//
+//  Manager::releaseSlot
+//
+//  \brief Return a slot to the free list
 //
-//  \return vector of Items
+//  \param slot
+//
+//  Bumping the generation invalidates every handle issued for the slot
+//
+//  \return none
 //
 //**********************************************************************************
-template< typename Item, typename Tag >
-void Manager::getItems( )
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::releaseSlot( uint32_t slot )
 {
-  
-  
-  
-} // Manager::getItems
+  slots_[ slot ].generation++;
+  slots_[ slot ].dense = freeSlot_;
+  freeSlot_            = slot;
+}
+
+//**********************************************************************************
+//
+//  Manager::eraseSlot
+//
+//  \brief Remove the item of a slot already dropped from the index
+//
+//  \param slot
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::eraseSlot( uint32_t slot )
+{
+  uint32_t dense = slots_[ slot ].dense;
+  uint32_t last  = static_cast< uint32_t >( items_.size( ) - 1 );
+
+  items_.erase( dense );
+
+  if ( dense != last )
+  {
+    tags_       [ dense ] = std::move( tags_ [ last ] );
+    denseToSlot_[ dense ] = denseToSlot_[ last ];
+    pins_       [ dense ] = pins_       [ last ];
+
+    slots_[ denseToSlot_[ dense ] ].dense = dense;
+  }
+
+  tags_       .pop_back( );
+  denseToSlot_.pop_back( );
+  pins_       .pop_back( );
+  eviction_   .onErase( dense );
+
+  releaseSlot( slot );
+}
+
+//**********************************************************************************
+//
+//  Manager::handleOf
+//
+//  \brief Handle for a live slot
+//
+//  \param slot
+//
+//  \return handle
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+sHandle_t Manager< Item, Tag, Index, Eviction, Storage >::handleOf( uint32_t slot ) const
+{
+  sHandle_t handle;
+  handle.index      = slot;
+  handle.generation = slots_[ slot ].generation;
+  return handle;
+}
+
+//**********************************************************************************
+//
+//  Manager::evictOver
+//
+//  \brief Evict victims chosen by the policy while over budget
+//
+//  \param keep slot that must survive, the item just added
+//
+//  Stops early once every remaining item is pinned, pins over budget leave the
+//  manager at its pinned floor. The kept item counts as pinned meanwhile so the
+//  policy knows it cannot be evicted either
+//
+//  \return number of items evicted
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+size_t Manager< Item, Tag, Index, Eviction, Storage >::evictOver( uint32_t keep )
+{
+  if ( !eviction_.overBudget( ) )
+  {
+    return 0;
+  }
+
+  size_t uiEvicted = 0;
+  bool   bHold     = keep != INDEX_NPOS && pins_[ slots_[ keep ].dense ] == 0;
+
+  if ( bHold )
+  {
+    eviction_.onPin( slots_[ keep ].dense );
+  }
+
+  while ( eviction_.overBudget( ) )
+  {
+    uint32_t dense = eviction_.victim( [ this, keep ]( uint32_t d )
+                                       { return pins_[ d ] != 0 || denseToSlot_[ d ] == keep; } );
+    if ( dense == INDEX_NPOS )
+    {
+      break;
+    }
+
+    uint32_t slot = denseToSlot_[ dense ];
+    index_.erase( tags_[ dense ], keyOf( ) );
+    eraseSlot( slot );
+    uiEvicted++;
+  }
+
+  //
+  // The kept item may have been moved into an evicted item's dense position
+  //
+  if ( bHold )
+  {
+    eviction_.onUnpin( slots_[ keep ].dense );
+  }
+
+  statsCount( STATS_EVICTIONS, uiEvicted );
+  return uiEvicted;
+}
+
+//**********************************************************************************
+//
+//  Manager::enableStats
+//
+//  \brief Start collecting stats, counters restart from zero
+//
+//  \param ssName name in the registry
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::enableStats( const std::string& ssName )
+{
+  stats_.reset( new ManagerStats( ssName ) );
+  statsResize( );
+}
+
+//**********************************************************************************
+//
+//  Manager::statsEnd
+//
+//  \brief Finish a lookup counted by statsStart( )
+//
+//  \param bHit
+//  \param u64Start from statsStart( ), 0 if the lookup is not timed
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::statsEnd( bool bHit, uint64_t u64Start ) const
+{
+  if ( stats_.get( ) != nullptr )
+  {
+    stats_.get( )->endLookup( bHit, u64Start );
+  }
+}
+
+//**********************************************************************************
+//
+//  Manager::statsCount
+//
+//  \brief Add to a counter
+//
+//  \param eCounter
+//  \param u64Count
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::statsCount( eStatsCounter_t eCounter,
+                                                                 uint64_t        u64Count ) const
+{
+  if ( stats_.get( ) != nullptr )
+  {
+    stats_.get( )->count( eCounter, u64Count );
+  }
+}
+
+//**********************************************************************************
+//
+//  Manager::statsResize
+//
+//  \brief Publish the resident item count and byte estimate
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void Manager< Item, Tag, Index, Eviction, Storage >::statsResize( ) const
+{
+  if ( stats_.get( ) == nullptr )
+  {
+    return;
+  }
+
+  uint64_t u64Bytes = eviction_.bytes( );
+
+  if ( u64Bytes == 0 )
+  {
+    u64Bytes = static_cast< uint64_t >( size( ) ) * sizeof( Item );
+  }
+
+  stats_.get( )->setResident( size( ), u64Bytes );
+} // Manager::statsResize
 
 
 } // namespace resources
 
 } // namespace components
 
-#endif // __RESOURCES_MANAGER_H__
\ No newline at end of file
+#endif // __RESOURCES_MANAGER_H__
@@ -0,0 +1,511 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Pack.cpp
+//  Author  : Anthony Islas
+//  Purpose : Resource pack views and builder implementation
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <utility>
+
+#include <unistd.h>
+
+#include "Pack.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+namespace
+{
+
+//**********************************************************************************
+//
+//  validTree
+//
+//  \brief Check a PACK_GSF tree stays inside its entry
+//
+//  \param pTree  start of the entry
+//  \param u64Size entry size in bytes
+//
+//  Children must come after their parent, as the breadth first layout puts
+//  them, so a corrupt tree cannot send toElement( ) round a cycle
+//
+//  \return true if every node, line and character is in bounds
+//
+//**********************************************************************************
+bool validTree( const char* pTree, uint64_t u64Size )
+{
+  if ( reinterpret_cast< uintptr_t >( pTree ) % alignof( sPackNode_t ) != 0 ||
+       u64Size < sizeof( sPackTree_t ) )
+  {
+    return false;
+  }
+
+  const sPackTree_t* pHeader = reinterpret_cast< const sPackTree_t* >( pTree );
+  uint64_t           u64Body = sizeof( sPackTree_t ) +
+                               static_cast< uint64_t >( pHeader->nodes ) * sizeof( sPackNode_t ) +
+                               static_cast< uint64_t >( pHeader->lines ) * sizeof( sPackString_t );
+
+  if ( pHeader->nodes == 0 || u64Body > u64Size )
+  {
+    return false;
+  }
+
+  const sPackNode_t*   pNodes   = reinterpret_cast< const sPackNode_t* >( pHeader + 1 );
+  const sPackString_t* pStrings = reinterpret_cast< const sPackString_t* >( pNodes + pHeader->nodes );
+  uint64_t             u64Chars = u64Size - u64Body;
+
+  for ( uint32_t i = 0; i < pHeader->nodes; i++ )
+  {
+    const sPackNode_t& sNode = pNodes[ i ];
+
+    if ( static_cast< uint64_t >( sNode.firstLine ) + sNode.lineCount > pHeader->lines ||
+         static_cast< uint64_t >( sNode.firstChild ) + sNode.childCount > pHeader->nodes ||
+         ( sNode.childCount != 0 && sNode.firstChild <= i ) )
+    {
+      return false;
+    }
+  }
+
+  for ( uint32_t i = 0; i < pHeader->lines; i++ )
+  {
+    if ( static_cast< uint64_t >( pStrings[ i ].offset ) + pStrings[ i ].size > u64Chars )
+    {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+} // namespace
+
+//**********************************************************************************
+//
+//  packHash
+//
+//  \brief 64 bit FNV-1a of a tag
+//
+//  \param pData  tag characters
+//  \param uiSize number of characters
+//
+//  \return hash
+//
+//**********************************************************************************
+uint64_t packHash( const char* pData, size_t uiSize )
+{
+  uint64_t u64Hash = 0xCBF29CE484222325ull;
+
+  for ( size_t i = 0; i < uiSize; i++ )
+  {
+    u64Hash ^= static_cast< unsigned char >( pData[ i ] );
+    u64Hash *= 0x100000001B3ull;
+  }
+
+  return u64Hash;
+}
+
+//**********************************************************************************
+//
+//  PackNode::line
+//
+//  \brief One of the node's own lines
+//
+//  \param i line of this node
+//
+//  \return characters, not null terminated
+//
+//**********************************************************************************
+Span< const char > PackNode::line( size_t i ) const
+{
+  const sPackString_t& sString = strings( )[ node( ).firstLine + i ];
+  return Span< const char >( chars( ) + sString.offset, sString.size );
+}
+
+//**********************************************************************************
+//
+//  PackNode::child
+//
+//  \brief One of the node's nested elements
+//
+//  \param i child of this node
+//
+//  \return node
+//
+//**********************************************************************************
+PackNode PackNode::child( size_t i ) const
+{
+  return PackNode( pTree_, node( ).firstChild + static_cast< uint32_t >( i ) );
+}
+
+//**********************************************************************************
+//
+//  PackNode::toElement
+//
+//  \brief Copy the subtree out into a parse element
+//
+//  \return element
+//
+//**********************************************************************************
+sParseElement_t PackNode::toElement( ) const
+{
+  sParseElement_t sElem;
+
+  for ( size_t i = 0; i < lines( ); i++ )
+  {
+    Span< const char > ssLine = line( i );
+    sElem.vElementLines.push_back( std::string( ssLine.begin( ), ssLine.end( ) ) );
+  }
+
+  for ( size_t i = 0; i < children( ); i++ )
+  {
+    sElem.vChildren.push_back( child( i ).toElement( ) );
+  }
+
+  return sElem;
+}
+
+//**********************************************************************************
+//
+//  PackItem::root
+//
+//  \brief Tree of a pre-parsed .gsf entry
+//
+//  Every node and line is bounds checked against the entry first, linear in
+//  the size of the tree, so the nodes reached from a valid root are safe to walk
+//
+//  \return root node, invalid for other entry types or a corrupt tree
+//
+//**********************************************************************************
+PackNode PackItem::root( ) const
+{
+  if ( !valid( ) || type( ) != PACK_GSF )
+  {
+    return PackNode( );
+  }
+
+  if ( !validTree( pBase_ + pEntry_->dataOffset, pEntry_->dataSize ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " corrupt tree in pack entry \""
+                              << std::string( tag( ).begin( ), tag( ).end( ) ) << "\"" << std::endl;
+    return PackNode( );
+  }
+
+  return PackNode( pBase_ + pEntry_->dataOffset, 0 );
+}
+
+//**********************************************************************************
+//
+//  PackBuilder::addRaw
+//
+//  \brief Add bytes as they are
+//
+//  \param ssTag
+//  \param pData
+//  \param uiSize
+//
+//  \return none
+//
+//**********************************************************************************
+void PackBuilder::addRaw( const std::string& ssTag, const void* pData, size_t uiSize )
+{
+  sPendingEntry_t sEntry;
+  sEntry.ssTag = ssTag;
+  sEntry.type  = PACK_RAW;
+  sEntry.vData.assign( static_cast< const char* >( pData ),
+                       static_cast< const char* >( pData ) + uiSize );
+
+  vEntries_.push_back( std::move( sEntry ) );
+}
+
+//**********************************************************************************
+//
+//  PackBuilder::addFile
+//
+//  \brief Add a file's bytes
+//
+//  \param ssTag
+//  \param ssPath
+//
+//  \return false if the file could not be read
+//
+//**********************************************************************************
+bool PackBuilder::addFile( const std::string& ssTag, const std::string& ssPath )
+{
+  std::ifstream ifFile( ssPath.c_str( ), std::ios::binary );
+
+  if ( !ifFile.is_open( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " unable to open file \""
+                              << ssPath   << "\"" << std::endl;
+    return false;
+  }
+
+  std::vector< char > vData( ( std::istreambuf_iterator< char >( ifFile ) ),
+                             std::istreambuf_iterator< char >( ) );
+
+  addRaw( ssTag, vData.data( ), vData.size( ) );
+  return true;
+}
+
+//**********************************************************************************
+//
+//  PackBuilder::addTree
+//
+//  \brief Add a parsed tree, flattened breadth first
+//
+//  \param ssTag
+//  \param sElem root element
+//
+//  \return none
+//
+//**********************************************************************************
+void PackBuilder::addTree( const std::string& ssTag, const sParseElement_t& sElem )
+{
+  std::vector< const sParseElement_t* > vQueue( 1, &sElem );
+  std::vector< sPackNode_t >            vNodes( 1 );
+  std::vector< sPackString_t >          vLines;
+  std::string                           ssChars;
+
+  for ( size_t i = 0; i < vQueue.size( ); i++ )
+  {
+    const sParseElement_t* pElem = vQueue[ i ];
+
+    vNodes[ i ].firstLine  = static_cast< uint32_t >( vLines.size( ) );
+    vNodes[ i ].lineCount  = static_cast< uint32_t >( pElem->vElementLines.size( ) );
+    vNodes[ i ].firstChild = static_cast< uint32_t >( vQueue.size( ) );
+    vNodes[ i ].childCount = static_cast< uint32_t >( pElem->vChildren.size( ) );
+
+    for ( size_t j = 0; j < pElem->vElementLines.size( ); j++ )
+    {
+      sPackString_t sLine;
+      sLine.offset = static_cast< uint32_t >( ssChars.size( ) );
+      sLine.size   = static_cast< uint32_t >( pElem->vElementLines[ j ].size( ) );
+
+      vLines.push_back( sLine );
+      ssChars += pElem->vElementLines[ j ];
+    }
+
+    for ( size_t j = 0; j < pElem->vChildren.size( ); j++ )
+    {
+      vQueue.push_back( &pElem->vChildren[ j ] );
+      vNodes.push_back( sPackNode_t( ) );
+    }
+  }
+
+  sPackTree_t sTree;
+  sTree.nodes = static_cast< uint32_t >( vNodes.size( ) );
+  sTree.lines = static_cast< uint32_t >( vLines.size( ) );
+
+  sPendingEntry_t sEntry;
+  sEntry.ssTag = ssTag;
+  sEntry.type  = PACK_GSF;
+  sEntry.vData.resize( sizeof( sTree ) +
+                       vNodes.size( ) * sizeof( sPackNode_t ) +
+                       vLines.size( ) * sizeof( sPackString_t ) +
+                       ssChars.size( ) );
+
+  char* pOut = sEntry.vData.data( );
+  std::memcpy( pOut, &sTree, sizeof( sTree ) );
+  pOut += sizeof( sTree );
+  std::memcpy( pOut, vNodes.data( ), vNodes.size( ) * sizeof( sPackNode_t ) );
+  pOut += vNodes.size( ) * sizeof( sPackNode_t );
+  if ( !vLines.empty( ) )
+  {
+    std::memcpy( pOut, vLines.data( ), vLines.size( ) * sizeof( sPackString_t ) );
+    pOut += vLines.size( ) * sizeof( sPackString_t );
+  }
+  std::memcpy( pOut, ssChars.data( ), ssChars.size( ) );
+
+  vEntries_.push_back( std::move( sEntry ) );
+}
+
+//**********************************************************************************
+//
+//  PackBuilder::addGsf
+//
+//  \brief Parse a .gsf file now and add its tree
+//
+//  \param ssTag
+//  \param ssPath
+//  \param parser configured for the file's syntax
+//
+//  \return false if the file could not be read
+//
+//**********************************************************************************
+bool PackBuilder::addGsf( const std::string& ssTag, const std::string& ssPath, Parser& parser )
+{
+  sParseElement_t sElem;
+
+  if ( !parser.ParseFile( ssPath, sElem ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " unable to open file \""
+                              << ssPath   << "\"" << std::endl;
+    return false;
+  }
+
+  addTree( ssTag, sElem );
+  return true;
+}
+
+//**********************************************************************************
+//
+//  PackBuilder::write
+//
+//  \brief Write every entry added so far as one pack
+//
+//  \param ssPath output file
+//
+//  The pack is written next to ssPath and renamed over it, processes that have
+//  the old pack mapped keep reading the old inode instead of faulting on pages
+//  truncated under them
+//
+//  \return false on duplicate tags or if the file could not be written
+//
+//**********************************************************************************
+bool PackBuilder::write( const std::string& ssPath ) const
+{
+  typedef std::pair< uint64_t, const sPendingEntry_t* > Sorted_t;
+
+  std::vector< Sorted_t > vSorted;
+
+  for ( size_t i = 0; i < vEntries_.size( ); i++ )
+  {
+    const std::string& ssTag = vEntries_[ i ].ssTag;
+    vSorted.push_back( Sorted_t( packHash( ssTag.data( ), ssTag.size( ) ), &vEntries_[ i ] ) );
+  }
+
+  std::sort( vSorted.begin( ), vSorted.end( ),
+             []( const Sorted_t& a, const Sorted_t& b )
+             {
+               return a.first != b.first ? a.first < b.first : a.second->ssTag < b.second->ssTag;
+             } );
+
+  for ( size_t i = 1; i < vSorted.size( ); i++ )
+  {
+    if ( vSorted[ i ].second->ssTag == vSorted[ i - 1 ].second->ssTag )
+    {
+      std::cerr << "Error at: " << __FILE__ << ":"
+                                << __LINE__ << " duplicate tag \""
+                                << vSorted[ i ].second->ssTag << "\"" << std::endl;
+      return false;
+    }
+  }
+
+  //
+  // Lay out the tag characters after the index and every blob 8 byte aligned
+  // after them
+  //
+  sPackHeader_t sHeader;
+  std::memcpy( sHeader.magic, PACK_MAGIC, sizeof( PACK_MAGIC ) );
+  sHeader.version    = PACK_VERSION;
+  sHeader.count      = static_cast< uint32_t >( vSorted.size( ) );
+  sHeader.tagsOffset = sizeof( sPackHeader_t ) + vSorted.size( ) * sizeof( sPackEntry_t );
+
+  std::vector< sPackEntry_t > vIndex( vSorted.size( ) );
+  std::string                 ssTags;
+
+  for ( size_t i = 0; i < vSorted.size( ); i++ )
+  {
+    const sPendingEntry_t* pEntry = vSorted[ i ].second;
+
+    vIndex[ i ].hash      = vSorted[ i ].first;
+    vIndex[ i ].tagOffset = static_cast< uint32_t >( sHeader.tagsOffset + ssTags.size( ) );
+    vIndex[ i ].tagSize   = static_cast< uint32_t >( pEntry->ssTag.size( ) );
+    vIndex[ i ].type      = pEntry->type;
+    vIndex[ i ].reserved  = 0;
+    ssTags += pEntry->ssTag;
+  }
+
+  uint64_t u64Offset = ( sHeader.tagsOffset + ssTags.size( ) + 7 ) & ~7ull;
+  sHeader.dataOffset = u64Offset;
+
+  for ( size_t i = 0; i < vSorted.size( ); i++ )
+  {
+    vIndex[ i ].dataOffset = u64Offset;
+    vIndex[ i ].dataSize   = vSorted[ i ].second->vData.size( );
+    u64Offset              = ( u64Offset + vIndex[ i ].dataSize + 7 ) & ~7ull;
+  }
+  sHeader.fileSize = u64Offset;
+
+  std::string   ssTemp = ssPath + ".tmp" + std::to_string( getpid( ) );
+  std::ofstream ofFile( ssTemp.c_str( ), std::ios::binary | std::ios::trunc );
+
+  if ( !ofFile.is_open( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " unable to open file \""
+                              << ssTemp   << "\"" << std::endl;
+    return false;
+  }
+
+  static const char PADDING[ 8 ] = { 0 };
+
+  ofFile.write( reinterpret_cast< const char* >( &sHeader ), sizeof( sHeader ) );
+  ofFile.write( reinterpret_cast< const char* >( vIndex.data( ) ),
+                vIndex.size( ) * sizeof( sPackEntry_t ) );
+  ofFile.write( ssTags.data( ), ssTags.size( ) );
+  ofFile.write( PADDING, sHeader.dataOffset - sHeader.tagsOffset - ssTags.size( ) );
+
+  for ( size_t i = 0; i < vSorted.size( ); i++ )
+  {
+    const std::vector< char >& vData = vSorted[ i ].second->vData;
+
+    ofFile.write( vData.data( ), vData.size( ) );
+    ofFile.write( PADDING, ( 8 - vData.size( ) % 8 ) % 8 );
+  }
+
+  ofFile.close( );
+
+  if ( ofFile.fail( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " failed writing \""
+                              << ssTemp   << "\"" << std::endl;
+    std::remove( ssTemp.c_str( ) );
+    return false;
+  }
+
+  if ( std::rename( ssTemp.c_str( ), ssPath.c_str( ) ) != 0 )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " unable to replace \""
+                              << ssPath   << "\"" << std::endl;
+    std::remove( ssTemp.c_str( ) );
+    return false;
+  }
+
+  return true;
+}
+
+} // namespace resources
+
+} // namespace components
@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Pack.hpp
+//  Author  : Anthony Islas
+//  Purpose : Resource pack archive format, zero-copy views into it and the
+//            builder writing it
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_PACK_H__
+#define __RESOURCES_PACK_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Parser.hpp"
+#include "Span.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Layout, all offsets from the start of the file, little endian host order
+//
+//   sPackHeader_t
+//   sPackEntry_t[ count ]   sorted by ( hash, tag ), binary searched in place
+//   tag characters
+//   entry data, each 8 byte aligned
+//
+// A PACK_GSF entry holds a parsed .gsf tree flattened breadth first so every
+// node's children are contiguous
+//
+//   sPackTree_t
+//   sPackNode_t[ nodes ]
+//   sPackString_t[ lines ]  offsets from the first character
+//   line characters
+//
+static const char     PACK_MAGIC[ 8 ] = { 'C', 'M', 'P', 'P', 'A', 'C', 'K', '\0' };
+static const uint32_t PACK_VERSION    = 1;
+
+typedef enum ePackType
+{
+  PACK_RAW = 0,
+  PACK_GSF = 1
+} ePackType_t;
+
+typedef struct sPackHeaderStructure
+{
+  char     magic[ 8 ];
+  uint32_t version;
+  uint32_t count;
+  uint64_t tagsOffset;
+  uint64_t dataOffset;
+  uint64_t fileSize;
+} sPackHeader_t;
+
+typedef struct sPackEntryStructure
+{
+  uint64_t hash;
+  uint64_t dataOffset;
+  uint64_t dataSize;
+  uint32_t tagOffset;
+  uint32_t tagSize;
+  uint32_t type;
+  uint32_t reserved;
+} sPackEntry_t;
+
+typedef struct sPackTreeStructure
+{
+  uint32_t nodes;
+  uint32_t lines;
+} sPackTree_t;
+
+typedef struct sPackNodeStructure
+{
+  uint32_t firstLine;
+  uint32_t lineCount;
+  uint32_t firstChild;
+  uint32_t childCount;
+} sPackNode_t;
+
+typedef struct sPackStringStructure
+{
+  uint32_t offset;
+  uint32_t size;
+} sPackString_t;
+
+//
+// Stable across processes and builds, unlike std::hash
+//
+uint64_t packHash( const char* pData, size_t uiSize );
+
+//
+// View of one node of a PACK_GSF tree, valid while the pack is open
+//
+class PackNode
+{
+public:
+  PackNode( ) : pTree_( nullptr ), uiNode_( 0 ) { }
+  PackNode( const char* pTree, uint32_t uiNode ) : pTree_( pTree ), uiNode_( uiNode ) { }
+
+  bool valid( ) const { return pTree_ != nullptr; }
+
+  size_t             lines   ( ) const { return node( ).lineCount;  }
+  size_t             children( ) const { return node( ).childCount; }
+  Span< const char > line    ( size_t i ) const;
+  PackNode           child   ( size_t i ) const;
+
+  //
+  // Copy out as the parser's own tree
+  //
+  sParseElement_t toElement( ) const;
+
+private:
+  const sPackTree_t*   tree   ( ) const { return reinterpret_cast< const sPackTree_t* >( pTree_ ); }
+  const sPackNode_t*   nodes  ( ) const { return reinterpret_cast< const sPackNode_t* >( tree( ) + 1 ); }
+  const sPackString_t* strings( ) const { return reinterpret_cast< const sPackString_t* >( nodes( ) + tree( )->nodes ); }
+  const char*          chars  ( ) const { return reinterpret_cast< const char* >( strings( ) + tree( )->lines ); }
+  const sPackNode_t&   node   ( ) const { return nodes( )[ uiNode_ ]; }
+
+  const char* pTree_;
+  uint32_t    uiNode_;
+};
+
+//
+// View of one pack entry, valid while the pack is open
+//
+class PackItem
+{
+public:
+  PackItem( ) : pEntry_( nullptr ), pBase_( nullptr ) { }
+  PackItem( const sPackEntry_t* pEntry, const char* pBase ) : pEntry_( pEntry ), pBase_( pBase ) { }
+
+  bool        valid( ) const { return pEntry_ != nullptr; }
+  ePackType_t type ( ) const { return static_cast< ePackType_t >( pEntry_->type ); }
+
+  Span< const char > tag  ( ) const { return Span< const char >( pBase_ + pEntry_->tagOffset,  pEntry_->tagSize  ); }
+  Span< const char > bytes( ) const { return Span< const char >( pBase_ + pEntry_->dataOffset, pEntry_->dataSize ); }
+
+  //
+  // Root of a PACK_GSF entry, invalid node for raw entries and for trees that
+  // do not fit inside their entry
+  //
+  PackNode root( ) const;
+
+private:
+  const sPackEntry_t* pEntry_;
+  const char*         pBase_;
+};
+
+//
+// Collects entries in memory and writes them as one pack
+//
+class PackBuilder
+{
+public:
+  PackBuilder( ) { }
+  virtual ~PackBuilder( ) { }
+
+  void addRaw ( const std::string& ssTag, const void* pData, size_t uiSize );
+  bool addFile( const std::string& ssTag, const std::string& ssPath );
+  void addTree( const std::string& ssTag, const sParseElement_t& sElem );
+  bool addGsf ( const std::string& ssTag, const std::string& ssPath, Parser& parser );
+
+  size_t size ( ) const { return vEntries_.size( ); }
+  bool   write( const std::string& ssPath ) const;
+
+private:
+  typedef struct sPendingEntryStructure
+  {
+    std::string         ssTag;
+    uint32_t            type;
+    std::vector< char > vData;
+  } sPendingEntry_t;
+
+  std::vector< sPendingEntry_t > vEntries_;
+};
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_PACK_H__
@@ -0,0 +1,324 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : PackManager.cpp
+//  Author  : Anthony Islas
+//  Purpose : Memory mapped pack manager implementation
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <iostream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "PackManager.hpp"
+#include "Profiler.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//**********************************************************************************
+//
+//  PackManager::PackManager
+//
+//  \brief Closed pack manager
+//
+//  \return PackManager
+//
+//**********************************************************************************
+PackManager::PackManager( ) : pMap_         ( nullptr ),
+                              uiMapSize_    ( 0 ),
+                              pHeader_      ( nullptr ),
+                              pEntries_     ( nullptr ),
+                              u32Generation_( 0 )
+{ }
+
+//**********************************************************************************
+//
+//  PackManager::~PackManager
+//
+//  \brief DTOR, unmaps the pack
+//
+//  \return none
+//
+//**********************************************************************************
+PackManager::~PackManager( )
+{
+  close( );
+}
+
+//**********************************************************************************
+//
+//  PackManager::open
+//
+//  \brief Map a pack, closing any pack already open
+//
+//  \param ssPath
+//
+//  \return false if the file is missing or not a pack of this version
+//
+//**********************************************************************************
+bool PackManager::open( const std::string& ssPath )
+{
+  PROFILE_SCOPE( "PackManager::open" );
+
+  close( );
+
+  int iFd = ::open( ssPath.c_str( ), O_RDONLY );
+
+  if ( iFd < 0 )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " unable to open file \""
+                              << ssPath   << "\"" << std::endl;
+    return false;
+  }
+
+  struct stat sStat;
+
+  if ( fstat( iFd, &sStat ) != 0 || static_cast< size_t >( sStat.st_size ) < sizeof( sPackHeader_t ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " \"" << ssPath
+                              << "\" is too small for a pack" << std::endl;
+    ::close( iFd );
+    return false;
+  }
+
+  void* pMap = mmap( nullptr, sStat.st_size, PROT_READ, MAP_SHARED, iFd, 0 );
+
+  //
+  // The mapping keeps the file alive
+  //
+  ::close( iFd );
+
+  if ( pMap == MAP_FAILED )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " unable to map \""
+                              << ssPath   << "\"" << std::endl;
+    return false;
+  }
+
+  const sPackHeader_t* pHeader  = static_cast< const sPackHeader_t* >( pMap );
+  size_t               uiSize   = static_cast< size_t >( sStat.st_size );
+  uint64_t             u64Index = sizeof( sPackHeader_t ) +
+                                  static_cast< uint64_t >( pHeader->count ) * sizeof( sPackEntry_t );
+
+  if ( std::memcmp( pHeader->magic, PACK_MAGIC, sizeof( PACK_MAGIC ) ) != 0 ||
+       pHeader->version    != PACK_VERSION ||
+       pHeader->fileSize   != uiSize       ||
+       pHeader->tagsOffset != u64Index     ||
+       pHeader->dataOffset <  u64Index     ||
+       pHeader->dataOffset >  uiSize )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " \"" << ssPath
+                              << "\" is not a version " << PACK_VERSION << " pack"
+                              << std::endl;
+    munmap( pMap, uiSize );
+    return false;
+  }
+
+  pMap_      = static_cast< const char* >( pMap );
+  uiMapSize_ = uiSize;
+  pHeader_   = pHeader;
+  pEntries_  = reinterpret_cast< const sPackEntry_t* >( pHeader + 1 );
+  u32Generation_++;
+  return true;
+}
+
+//**********************************************************************************
+//
+//  PackManager::close
+//
+//  \brief Unmap the pack, every view and handle into it becomes invalid
+//
+//  \return none
+//
+//**********************************************************************************
+void PackManager::close( )
+{
+  if ( pMap_ != nullptr )
+  {
+    munmap( const_cast< char* >( pMap_ ), uiMapSize_ );
+  }
+
+  pMap_      = nullptr;
+  uiMapSize_ = 0;
+  pHeader_   = nullptr;
+  pEntries_  = nullptr;
+}
+
+//**********************************************************************************
+//
+//  PackManager::getItem
+//
+//  \brief Look up an entry by tag
+//
+//  \param ssTag
+//
+//  \return view of the entry, invalid if no entry has the tag
+//
+//**********************************************************************************
+PackItem PackManager::getItem( const std::string& ssTag ) const
+{
+  return itemAt( find( ssTag ) );
+}
+
+//**********************************************************************************
+//
+//  PackManager::getHandle
+//
+//  \brief Resolve a tag once so later lookups skip the search
+//
+//  \param ssTag
+//
+//  \return handle, INVALID_HANDLE if no entry has the tag
+//
+//**********************************************************************************
+sHandle_t PackManager::getHandle( const std::string& ssTag ) const
+{
+  uint32_t entry = find( ssTag );
+
+  if ( entry == INDEX_NPOS )
+  {
+    return INVALID_HANDLE;
+  }
+
+  sHandle_t handle;
+  handle.index      = entry;
+  handle.generation = u32Generation_;
+  return handle;
+}
+
+//**********************************************************************************
+//
+//  PackManager::getItem
+//
+//  \brief Look up an entry by handle
+//
+//  \param handle
+//
+//  \return view of the entry, invalid for a handle of another open
+//
+//**********************************************************************************
+PackItem PackManager::getItem( sHandle_t handle ) const
+{
+  if ( !isOpen( ) || handle.generation != u32Generation_ )
+  {
+    return PackItem( );
+  }
+
+  return itemAt( handle.index );
+}
+
+//**********************************************************************************
+//
+//  PackManager::find
+//
+//  \brief Binary search the index on ( hash, tag )
+//
+//  \param ssTag
+//
+//  \return entry position or INDEX_NPOS
+//
+//**********************************************************************************
+uint32_t PackManager::find( const std::string& ssTag ) const
+{
+  if ( !isOpen( ) )
+  {
+    return INDEX_NPOS;
+  }
+
+  uint64_t u64Hash = packHash( ssTag.data( ), ssTag.size( ) );
+  uint32_t uiLow   = 0;
+  uint32_t uiHigh  = pHeader_->count;
+
+  while ( uiLow < uiHigh )
+  {
+    uint32_t uiMid = uiLow + ( uiHigh - uiLow ) / 2;
+
+    if ( pEntries_[ uiMid ].hash < u64Hash )
+    {
+      uiLow = uiMid + 1;
+    }
+    else
+    {
+      uiHigh = uiMid;
+    }
+  }
+
+  for ( uint32_t i = uiLow; i < pHeader_->count && pEntries_[ i ].hash == u64Hash; i++ )
+  {
+    const sPackEntry_t& sEntry = pEntries_[ i ];
+
+    if ( sEntry.tagSize == ssTag.size( ) &&
+         static_cast< uint64_t >( sEntry.tagOffset ) + sEntry.tagSize <= pHeader_->dataOffset &&
+         std::memcmp( pMap_ + sEntry.tagOffset, ssTag.data( ), ssTag.size( ) ) == 0 )
+    {
+      return i;
+    }
+  }
+
+  return INDEX_NPOS;
+}
+
+//**********************************************************************************
+//
+//  PackManager::itemAt
+//
+//  \brief View of an entry, checked against the mapping
+//
+//  \param entry position in the index
+//
+//  \return view, invalid if out of range or the entry points outside the pack
+//
+//**********************************************************************************
+PackItem PackManager::itemAt( uint32_t entry ) const
+{
+  if ( !isOpen( ) || entry >= pHeader_->count )
+  {
+    return PackItem( );
+  }
+
+  const sPackEntry_t& sEntry = pEntries_[ entry ];
+
+  if ( sEntry.dataOffset < pHeader_->dataOffset ||
+       sEntry.dataOffset > uiMapSize_           ||
+       sEntry.dataSize   > uiMapSize_ - sEntry.dataOffset )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " corrupt pack entry " << entry
+                              << std::endl;
+    return PackItem( );
+  }
+
+  return PackItem( &sEntry, pMap_ );
+}
+
+} // namespace resources
+
+} // namespace components
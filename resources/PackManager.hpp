@@ -0,0 +1,89 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : PackManager.hpp
+//  Author  : Anthony Islas
+//  Purpose : Read-only resource manager serving items straight out of a memory
+//            mapped pack
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_PACK_MANAGER_H__
+#define __RESOURCES_PACK_MANAGER_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Handle.hpp"
+#include "Pack.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Opening is one open + mmap and a header check, nothing is read or copied up
+// front. The mapping is shared and read-only so every process opening the same
+// pack shares its page cache. Lookups binary search the sorted index in place
+// and return views into the mapping, valid until close( )
+//
+class PackManager
+{
+public:
+  PackManager( );
+  virtual ~PackManager( );
+
+  bool open   ( const std::string& ssPath );
+  void close  ( );
+  bool isOpen ( ) const { return pHeader_ != nullptr; }
+
+  //
+  // Invalid item if no entry has the tag
+  //
+  PackItem  getItem  ( const std::string& ssTag ) const;
+  bool      hasItem  ( const std::string& ssTag ) const { return find( ssTag ) != INDEX_NPOS; }
+  sHandle_t getHandle( const std::string& ssTag ) const;
+
+  //
+  // Handles are entry positions, stale once the pack is closed
+  //
+  PackItem getItem( sHandle_t handle ) const;
+
+  size_t size( ) const { return isOpen( ) ? pHeader_->count : 0; }
+
+private:
+  PackManager( const PackManager& ) = delete;
+  PackManager& operator=( const PackManager& ) = delete;
+
+  uint32_t find  ( const std::string& ssTag ) const;
+  PackItem itemAt( uint32_t entry ) const;
+
+  const char*          pMap_;
+  size_t               uiMapSize_;
+  const sPackHeader_t* pHeader_;
+  const sPackEntry_t*  pEntries_;
+  uint32_t             u32Generation_;
+};
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_PACK_MANAGER_H__
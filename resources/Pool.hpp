@@ -0,0 +1,344 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Pool.hpp
+//  Author  : Anthony Islas
+//  Purpose : Per-type slab pool of fixed size blocks with a free list and optional
+//            thread-local caches
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_POOL_H__
+#define __RESOURCES_POOL_H__
+
+#include <cstddef>
+#include <mutex>
+#include <type_traits>
+#include <vector>
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Blocks are carved from slabs of SLAB_ITEMS and recycled through an intrusive
+// free list, slabs are only returned when the pool is destroyed, so once warm
+// allocate / deallocate never reach the global allocator. The free list is
+// shared by every thread under a mutex, a thread-local cache in front of it
+// moves blocks in batches of CACHE_BATCH
+//
+template< typename T, size_t SLAB_ITEMS = 64 >
+class SlabPool
+{
+public:
+  static const size_t CACHE_BATCH = 32;
+
+  SlabPool( ) : pFree_( nullptr ) { }
+  ~SlabPool( );
+
+  //
+  // Uninitialized block for one T
+  //
+  void* allocate  ( bool bThreadCache = false );
+  void  deallocate( void* p, bool bThreadCache = false );
+
+  size_t slabs( ) const { std::lock_guard< std::mutex > lock( mFree_ ); return vSlabs_.size( ); }
+
+  //
+  // Pool shared by every user of T
+  //
+  static SlabPool& shared( );
+
+private:
+  union uBlock
+  {
+    uBlock*                                                          pNext;
+    typename std::aligned_storage< sizeof( T ), alignof( T ) >::type storage;
+  };
+
+  typedef struct sCacheStructure
+  {
+    uBlock* pHead;
+    size_t  uiCount;
+
+    sCacheStructure( ) : pHead( nullptr ), uiCount( 0 ) { }
+    ~sCacheStructure( );
+  } sCache_t;
+
+  SlabPool( const SlabPool& ) = delete;
+  SlabPool& operator=( const SlabPool& ) = delete;
+
+  static sCache_t& cache( );
+
+  uBlock* take   ( size_t uiCount, size_t& rTaken );
+  void    give   ( uBlock* pHead, uBlock* pTail );
+  void    addSlab( );
+
+  mutable std::mutex     mFree_;
+  uBlock*                pFree_;
+  std::vector< uBlock* > vSlabs_;
+};
+
+
+//**********************************************************************************
+//
+//  SlabPool::~SlabPool
+//
+//  \brief DTOR, releases every slab, all blocks must have been returned
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename T, size_t SLAB_ITEMS >
+SlabPool< T, SLAB_ITEMS >::~SlabPool( )
+{
+  for ( size_t i = 0; i < vSlabs_.size( ); i++ )
+  {
+    delete [] vSlabs_[ i ];
+  }
+}
+
+//**********************************************************************************
+//
+//  SlabPool::allocate
+//
+//  \brief Take a block
+//
+//  \param bThreadCache go through the calling thread's cache
+//
+//  \return uninitialized storage for a T
+//
+//**********************************************************************************
+template< typename T, size_t SLAB_ITEMS >
+void* SlabPool< T, SLAB_ITEMS >::allocate( bool bThreadCache )
+{
+  if ( !bThreadCache )
+  {
+    size_t uiTaken = 0;
+    return take( 1, uiTaken );
+  }
+
+  sCache_t& sCache = cache( );
+
+  if ( sCache.pHead == nullptr )
+  {
+    sCache.pHead = take( CACHE_BATCH, sCache.uiCount );
+  }
+
+  uBlock* pBlock = sCache.pHead;
+  sCache.pHead   = pBlock->pNext;
+  sCache.uiCount--;
+  return pBlock;
+}
+
+//**********************************************************************************
+//
+//  SlabPool::deallocate
+//
+//  \brief Return a block, the T must already be destroyed
+//
+//  \param p            block from allocate( )
+//  \param bThreadCache go through the calling thread's cache
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename T, size_t SLAB_ITEMS >
+void SlabPool< T, SLAB_ITEMS >::deallocate( void* p, bool bThreadCache )
+{
+  uBlock* pBlock = static_cast< uBlock* >( p );
+
+  if ( !bThreadCache )
+  {
+    give( pBlock, pBlock );
+    return;
+  }
+
+  sCache_t& sCache = cache( );
+
+  pBlock->pNext = sCache.pHead;
+  sCache.pHead  = pBlock;
+  sCache.uiCount++;
+
+  //
+  // Keep at most two batches, hand one back so blocks freed on one thread
+  // reach the others
+  //
+  if ( sCache.uiCount >= 2 * CACHE_BATCH )
+  {
+    uBlock* pTail = sCache.pHead;
+    for ( size_t i = 1; i < CACHE_BATCH; i++ )
+    {
+      pTail = pTail->pNext;
+    }
+
+    uBlock* pHead  = sCache.pHead;
+    sCache.pHead   = pTail->pNext;
+    sCache.uiCount -= CACHE_BATCH;
+    give( pHead, pTail );
+  }
+}
+
+//**********************************************************************************
+//
+//  SlabPool::shared
+//
+//  \brief Process wide pool for T
+//
+//  \return pool
+//
+//**********************************************************************************
+template< typename T, size_t SLAB_ITEMS >
+SlabPool< T, SLAB_ITEMS >& SlabPool< T, SLAB_ITEMS >::shared( )
+{
+  static SlabPool pool;
+  return pool;
+}
+
+//**********************************************************************************
+//
+//  SlabPool::cache
+//
+//  \brief Calling thread's cache of shared( )
+//
+//  \return cache
+//
+//**********************************************************************************
+template< typename T, size_t SLAB_ITEMS >
+typename SlabPool< T, SLAB_ITEMS >::sCache_t& SlabPool< T, SLAB_ITEMS >::cache( )
+{
+  shared( );
+  static thread_local sCache_t sCache;
+  return sCache;
+}
+
+//**********************************************************************************
+//
+//  SlabPool::sCacheStructure::~sCacheStructure
+//
+//  \brief Thread exit, hand the cached blocks back to the shared pool
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename T, size_t SLAB_ITEMS >
+SlabPool< T, SLAB_ITEMS >::sCacheStructure::~sCacheStructure( )
+{
+  if ( pHead == nullptr )
+  {
+    return;
+  }
+
+  uBlock* pTail = pHead;
+  while ( pTail->pNext != nullptr )
+  {
+    pTail = pTail->pNext;
+  }
+
+  shared( ).give( pHead, pTail );
+}
+
+//**********************************************************************************
+//
+//  SlabPool::take
+//
+//  \brief Unlink up to uiCount blocks from the free list, growing it if empty
+//
+//  \param uiCount wanted
+//  \param rTaken  receives the number unlinked, at least one
+//
+//  \return null terminated list
+//
+//**********************************************************************************
+template< typename T, size_t SLAB_ITEMS >
+typename SlabPool< T, SLAB_ITEMS >::uBlock* SlabPool< T, SLAB_ITEMS >::take( size_t  uiCount,
+                                                                            size_t& rTaken )
+{
+  std::lock_guard< std::mutex > lock( mFree_ );
+
+  if ( pFree_ == nullptr )
+  {
+    addSlab( );
+  }
+
+  uBlock* pHead = pFree_;
+  uBlock* pTail = pFree_;
+  rTaken        = 1;
+
+  while ( rTaken < uiCount && pTail->pNext != nullptr )
+  {
+    pTail = pTail->pNext;
+    rTaken++;
+  }
+
+  pFree_       = pTail->pNext;
+  pTail->pNext = nullptr;
+  return pHead;
+}
+
+//**********************************************************************************
+//
+//  SlabPool::give
+//
+//  \brief Link a list of blocks back onto the free list
+//
+//  \param pHead first block
+//  \param pTail last block
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename T, size_t SLAB_ITEMS >
+void SlabPool< T, SLAB_ITEMS >::give( uBlock* pHead, uBlock* pTail )
+{
+  std::lock_guard< std::mutex > lock( mFree_ );
+
+  pTail->pNext = pFree_;
+  pFree_       = pHead;
+}
+
+//**********************************************************************************
+//
+//  SlabPool::addSlab
+//
+//  \brief Allocate a slab and thread its blocks onto the free list, lock held
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename T, size_t SLAB_ITEMS >
+void SlabPool< T, SLAB_ITEMS >::addSlab( )
+{
+  uBlock* pSlab = new uBlock[ SLAB_ITEMS ];
+
+  for ( size_t i = 0; i + 1 < SLAB_ITEMS; i++ )
+  {
+    pSlab[ i ].pNext = &pSlab[ i + 1 ];
+  }
+  pSlab[ SLAB_ITEMS - 1 ].pNext = pFree_;
+
+  pFree_ = pSlab;
+  vSlabs_.push_back( pSlab );
+}
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_POOL_H__
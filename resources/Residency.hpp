@@ -0,0 +1,305 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Residency.hpp
+//  Author  : Anthony Islas
+//  Purpose : Tick-aware residency, items stages declare for a tick are loaded
+//            in the background and pinned before it fires
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_RESIDENCY_H__
+#define __RESOURCES_RESIDENCY_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "Clock.hpp"
+#include "Handle.hpp"
+#include "Index.hpp"
+#include "Manager.hpp"
+#include "Profiler.hpp"
+#include "Span.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Stages declare, any time during tick n, the tags they will read in a later
+// tick. Registered with the clock as a listener holding the stages that read
+// the manager, the planner runs while those are between ticks and the other
+// stages stay pipelined. Once every stage completed tick n it starts background
+// loads, through the manager's loader pool, for everything declared so far, so
+// declarations for n + 1 load during the idle gap. A lead before each tick it
+// adopts finished loads and pins the declared items that are resident, so
+// eviction cannot drop them mid tick, and releases the pins once every stage
+// has completed the tick. The clock thread never loads, an item still loading
+// when its tick fires is counted in missing( ) and left to the stage's own miss
+// path. Declaring further ahead gives the loads more time, and the eviction
+// budget has to hold the items of every tick being loaded ahead. The manager is
+// only mutated by the clock thread while no holding stage is running, those
+// read it through the const lookups
+//
+template< typename Item,
+          typename Tag,
+          typename Index    = FlatHashIndex< Tag >,
+          typename Eviction = NoEviction,
+          typename Storage  = DenseStorage< Item > >
+class ResidencyPlanner : public timing::TickListener
+{
+public:
+  typedef Manager< Item, Tag, Index, Eviction, Storage > Manager_t;
+
+  explicit ResidencyPlanner( Manager_t& manager ) : manager_( manager ), uiMissing_( 0 ) { }
+  virtual ~ResidencyPlanner( ) { }
+
+  //
+  // Thread safe, called by stages
+  //
+  void declare( uint64_t u64Tick, const Tag& tag );
+  void declare( uint64_t u64Tick, Span< const Tag > tags );
+
+  virtual void beforeTick( uint64_t u64Tick ) override;
+  virtual void afterTick ( uint64_t u64Tick ) override;
+
+  //
+  // Clock thread only, or once the clock is stopped
+  //
+  size_t pinned ( ) const { return vPinned_.size( ); }
+  size_t missing( ) const { return uiMissing_;       }
+
+private:
+  ResidencyPlanner( const ResidencyPlanner& ) = delete;
+  ResidencyPlanner& operator=( const ResidencyPlanner& ) = delete;
+
+  void plan( uint64_t u64After );
+
+  Manager_t& manager_;
+
+  std::mutex                                mDeclared_;
+  std::vector< std::pair< uint64_t, Tag > > vDeclared_;
+
+  //
+  // Owned by the clock thread, declarations whose loads were started and the
+  // pins taken for each tick
+  //
+  std::vector< std::pair< uint64_t, Tag > >       vPlanned_;
+  std::vector< Tag >                              vLoading_;
+  std::vector< std::pair< uint64_t, sHandle_t > > vPinned_;
+  size_t                                          uiMissing_;
+};
+
+
+//**********************************************************************************
+//
+//  ResidencyPlanner::declare
+//
+//  \brief Request a tag be resident during a tick
+//
+//  \param u64Tick tick the tag is read in, declarations for past ticks are dropped
+//  \param tag
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void ResidencyPlanner< Item, Tag, Index, Eviction, Storage >::declare( uint64_t u64Tick, const Tag& tag )
+{
+  std::lock_guard< std::mutex > lock( mDeclared_ );
+  vDeclared_.push_back( std::make_pair( u64Tick, tag ) );
+}
+
+//**********************************************************************************
+//
+//  ResidencyPlanner::declare
+//
+//  \brief Request many tags be resident during a tick, under one lock
+//
+//  \param u64Tick
+//  \param tags
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void ResidencyPlanner< Item, Tag, Index, Eviction, Storage >::declare( uint64_t u64Tick, Span< const Tag > tags )
+{
+  std::lock_guard< std::mutex > lock( mDeclared_ );
+
+  for ( size_t i = 0; i < tags.size( ); i++ )
+  {
+    vDeclared_.push_back( std::make_pair( u64Tick, tags[ i ] ) );
+  }
+}
+
+//**********************************************************************************
+//
+//  ResidencyPlanner::beforeTick
+//
+//  \brief Pin everything declared for the tick that is resident
+//
+//  \param u64Tick
+//
+//  Declarations not yet taken by afterTick( ), e.g. those made before the clock
+//  started, are taken first. Resident items are pinned before finished loads
+//  are adopted, so inserting those cannot evict them. Declarations for past
+//  ticks are dropped
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void ResidencyPlanner< Item, Tag, Index, Eviction, Storage >::beforeTick( uint64_t u64Tick )
+{
+  PROFILE_SCOPE( "ResidencyPlanner::beforeTick" );
+
+  plan( u64Tick - 1 );
+  vLoading_.clear( );
+
+  size_t uiKept = 0;
+
+  for ( size_t i = 0; i < vPlanned_.size( ); i++ )
+  {
+    if ( vPlanned_[ i ].first > u64Tick )
+    {
+      vPlanned_[ uiKept++ ] = std::move( vPlanned_[ i ] );
+      continue;
+    }
+    if ( vPlanned_[ i ].first < u64Tick )
+    {
+      continue;
+    }
+
+    sHandle_t handle = manager_.getHandle( vPlanned_[ i ].second );
+
+    if ( manager_.pin( handle ) )
+    {
+      vPinned_.push_back( std::make_pair( u64Tick, handle ) );
+    }
+    else
+    {
+      vLoading_.push_back( std::move( vPlanned_[ i ].second ) );
+    }
+  }
+
+  vPlanned_.erase( vPlanned_.begin( ) + uiKept, vPlanned_.end( ) );
+
+  manager_.pollLoads( );
+
+  for ( size_t i = 0; i < vLoading_.size( ); i++ )
+  {
+    sHandle_t handle = manager_.getHandle( vLoading_[ i ] );
+
+    if ( manager_.pin( handle ) )
+    {
+      vPinned_.push_back( std::make_pair( u64Tick, handle ) );
+    }
+    else
+    {
+      uiMissing_++;
+    }
+  }
+}
+
+//**********************************************************************************
+//
+//  ResidencyPlanner::afterTick
+//
+//  \brief Release the pins taken for the tick and any earlier one, then start
+//         loading what has been declared since
+//
+//  \param u64Tick
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void ResidencyPlanner< Item, Tag, Index, Eviction, Storage >::afterTick( uint64_t u64Tick )
+{
+  PROFILE_SCOPE( "ResidencyPlanner::afterTick" );
+
+  size_t uiKept = 0;
+
+  for ( size_t i = 0; i < vPinned_.size( ); i++ )
+  {
+    if ( vPinned_[ i ].first <= u64Tick )
+    {
+      manager_.unpin( vPinned_[ i ].second );
+    }
+    else
+    {
+      vPinned_[ uiKept++ ] = vPinned_[ i ];
+    }
+  }
+
+  vPinned_.erase( vPinned_.begin( ) + uiKept, vPinned_.end( ) );
+
+  plan( u64Tick );
+}
+
+//**********************************************************************************
+//
+//  ResidencyPlanner::plan
+//
+//  \brief Take the declarations made so far and start loading their items
+//
+//  \param u64After declarations for this tick and earlier ones are dropped
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, typename Tag, typename Index, typename Eviction, typename Storage >
+void ResidencyPlanner< Item, Tag, Index, Eviction, Storage >::plan( uint64_t u64After )
+{
+  size_t uiPlanned = vPlanned_.size( );
+  {
+    std::lock_guard< std::mutex > lock( mDeclared_ );
+
+    for ( size_t i = 0; i < vDeclared_.size( ); i++ )
+    {
+      if ( vDeclared_[ i ].first > u64After )
+      {
+        vPlanned_.push_back( std::move( vDeclared_[ i ] ) );
+      }
+    }
+
+    vDeclared_.clear( );
+  }
+
+  //
+  // Loads already in flight for the same tag are shared
+  //
+  for ( size_t i = uiPlanned; i < vPlanned_.size( ); i++ )
+  {
+    if ( !manager_.hasItem( vPlanned_[ i ].second ) )
+    {
+      manager_.getItemAsync( vPlanned_[ i ].second );
+    }
+  }
+}
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_RESIDENCY_H__
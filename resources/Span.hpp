@@ -0,0 +1,137 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Span.hpp
+//  Author  : Anthony Islas
+//  Purpose : Non-owning view over contiguous elements
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_SPAN_H__
+#define __RESOURCES_SPAN_H__
+
+#include <cstddef>
+#include <iterator>
+#include <vector>
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Pointer + length, valid until the owning container is modified
+//
+template< typename T >
+class Span
+{
+public:
+  typedef T*     iterator;
+  typedef T      value_type;
+
+  Span( ) : pData_( nullptr ), uiSize_( 0 ) { }
+  Span( T* pData, size_t uiSize ) : pData_( pData ), uiSize_( uiSize ) { }
+
+  template< typename U, typename Alloc >
+  Span( std::vector< U, Alloc >& vData ) :
+        pData_ ( vData.data( ) ),
+        uiSize_( vData.size( ) )
+  { }
+
+  template< typename U, typename Alloc >
+  Span( const std::vector< U, Alloc >& vData ) :
+        pData_ ( vData.data( ) ),
+        uiSize_( vData.size( ) )
+  { }
+
+  T*     data ( ) const { return pData_;           }
+  size_t size ( ) const { return uiSize_;          }
+  bool   empty( ) const { return uiSize_ == 0;     }
+  T*     begin( ) const { return pData_;           }
+  T*     end  ( ) const { return pData_ + uiSize_; }
+
+  T& operator[]( size_t i ) const { return pData_[ i ]; }
+
+private:
+  T*     pData_;
+  size_t uiSize_;
+};
+
+//
+// Span over an array of pointers that iterates the pointees, for storage that
+// keeps items out of line
+//
+template< typename T >
+class IndirectSpan
+{
+public:
+  class iterator
+  {
+  public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T                               value_type;
+    typedef std::ptrdiff_t                  difference_type;
+    typedef T*                              pointer;
+    typedef T&                              reference;
+
+    explicit iterator( T* const* pp = nullptr ) : pp_( pp ) { }
+
+    T&        operator* ( ) const                        { return **pp_;            }
+    T*        operator->( ) const                        { return *pp_;             }
+    T&        operator[]( std::ptrdiff_t i ) const       { return *pp_[ i ];        }
+    iterator& operator++( )                              { ++pp_; return *this;     }
+    iterator  operator++( int )                          { return iterator( pp_++ ); }
+    iterator& operator--( )                              { --pp_; return *this;     }
+    iterator  operator--( int )                          { return iterator( pp_-- ); }
+    iterator& operator+=( std::ptrdiff_t i )             { pp_ += i; return *this;  }
+    iterator& operator-=( std::ptrdiff_t i )             { pp_ -= i; return *this;  }
+    iterator  operator+ ( std::ptrdiff_t i ) const       { return iterator( pp_ + i ); }
+    iterator  operator- ( std::ptrdiff_t i ) const       { return iterator( pp_ - i ); }
+
+    std::ptrdiff_t operator-( const iterator& rhs ) const { return pp_ - rhs.pp_; }
+
+    bool operator==( const iterator& rhs ) const { return pp_ == rhs.pp_; }
+    bool operator!=( const iterator& rhs ) const { return pp_ != rhs.pp_; }
+    bool operator< ( const iterator& rhs ) const { return pp_ <  rhs.pp_; }
+
+  private:
+    T* const* pp_;
+  };
+
+  typedef T value_type;
+
+  IndirectSpan( ) : ppData_( nullptr ), uiSize_( 0 ) { }
+  IndirectSpan( T* const* ppData, size_t uiSize ) : ppData_( ppData ), uiSize_( uiSize ) { }
+
+  size_t   size ( ) const { return uiSize_;                      }
+  bool     empty( ) const { return uiSize_ == 0;                 }
+  iterator begin( ) const { return iterator( ppData_ );           }
+  iterator end  ( ) const { return iterator( ppData_ + uiSize_ ); }
+
+  T& operator[]( size_t i ) const { return *ppData_[ i ]; }
+
+private:
+  T* const* ppData_;
+  size_t    uiSize_;
+};
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_SPAN_H__
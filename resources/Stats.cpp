@@ -0,0 +1,550 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Stats.cpp
+//  Author  : Anthony Islas
+//  Purpose : Manager statistics and registry implementation
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <thread>
+
+#include "Stats.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+namespace
+{
+
+//
+// Every live ManagerStats
+//
+std::mutex                   g_mStats;
+std::vector< ManagerStats* > g_vStats;
+
+//
+// Thread slot indices, returned by exiting threads for new ones to reuse, and
+// the pending counts of the thread holding each
+//
+std::mutex              g_mThreads;
+std::vector< uint32_t > g_vFreeThreads;
+uint32_t                g_uiNextThread = 0;
+sStatsThread_t*         g_apThreads[ COMPONENTS_STATS_THREADS ] = { };
+
+//
+// Serials are never reused, pending counts of a destroyed manager cannot be
+// taken for those of a new one allocated at the same address. A thread holds
+// BUSY_SERIAL while it adds its pending counts to their manager
+//
+std::atomic< uint64_t > g_u64NextSerial( 1 );
+const uint64_t          BUSY_SERIAL = ~0ull;
+
+const char* const g_apCounterNames[ STATS_COUNTERS ] =
+{
+  "lookups", "misses", "inserts", "evictions"
+};
+
+//
+// Pending lookups of a thread as a snapshot sees them. Mid update the base may
+// trail the countdown, that reads as none pending rather than a wrapped count
+//
+uint64_t pendingLookups( const sStatsThread_t& sThread )
+{
+  uint32_t uiPending = sThread.base.load( std::memory_order_relaxed ) -
+                       sThread.countdown.load( std::memory_order_relaxed );
+
+  return ( uiPending <= COMPONENTS_STATS_SAMPLE ) ? uiPending : 0;
+}
+
+//
+// Add a thread's pending counts to its slot, or drop them. They are cleared
+// first, a snapshot in between misses them for a moment rather than counting
+// them twice. Called by the owning thread only
+//
+void handOver( sStatsThread_t& sThread, bool bKeep )
+{
+  uint32_t uiCountdown = sThread.countdown.load( std::memory_order_relaxed );
+  uint64_t u64Lookups  = sThread.base.load( std::memory_order_relaxed ) - uiCountdown;
+  uint64_t u64Misses   = sThread.misses.load( std::memory_order_relaxed );
+
+  sThread.base  .store( uiCountdown, std::memory_order_relaxed );
+  sThread.misses.store( 0,           std::memory_order_relaxed );
+
+  if ( bKeep )
+  {
+    std::atomic< uint64_t >& rLookups = sThread.pCounters[ STATS_LOOKUPS ];
+    std::atomic< uint64_t >& rMisses  = sThread.pCounters[ STATS_MISSES  ];
+
+    rLookups.store( rLookups.load( std::memory_order_relaxed ) + u64Lookups, std::memory_order_relaxed );
+    rMisses .store( rMisses .load( std::memory_order_relaxed ) + u64Misses,  std::memory_order_relaxed );
+  }
+}
+
+//
+// Hand the pending counts to the manager they were counted for, unless it has
+// been destroyed since, and leave the thread holding none. Called by the
+// owning thread only
+//
+void releaseLookups( sStatsThread_t& sThread )
+{
+  uint64_t u64Serial = sThread.serial.exchange( BUSY_SERIAL, std::memory_order_acquire );
+
+  handOver( sThread, u64Serial != 0 );
+  sThread.serial.store( 0, std::memory_order_release );
+}
+
+//
+// Hands the calling thread's slot index back when the thread exits. Whatever
+// the thread counts after that goes to the shared overflow slot
+//
+struct sThreadGuard
+{
+  uint32_t*       pThread;
+  sStatsThread_t* pPending;
+  uint32_t        uiThread;
+  uint32_t        uiOverflow;
+
+  sThreadGuard( ) : pThread( nullptr ), pPending( nullptr ), uiThread( 0 ), uiOverflow( 0 ) { }
+
+  ~sThreadGuard( )
+  {
+    if ( pThread == nullptr || uiThread == uiOverflow )
+    {
+      return;
+    }
+
+    releaseLookups( *pPending );
+    *pThread = uiOverflow;
+
+    std::lock_guard< std::mutex > lock( g_mThreads );
+    g_apThreads   [ uiThread ] = nullptr;
+    g_vFreeThreads.push_back( uiThread );
+  }
+};
+
+} // namespace
+
+//**********************************************************************************
+//
+//  ManagerStats::ManagerStats
+//
+//  \brief Zeroed counters, registered under a name
+//
+//  \param ssName reported in the registry, need not be unique
+//
+//  \return ManagerStats
+//
+//**********************************************************************************
+ManagerStats::ManagerStats( const std::string& ssName ) :
+                            u64Serial_( g_u64NextSerial.fetch_add( 1, std::memory_order_relaxed ) ),
+                            ssName_( ssName ),
+                            vStorage_( ( STATS_OVERFLOW + 1 ) * sizeof( sStatsSlot_t ) + STATS_LINE ),
+                            pSlots_( nullptr ),
+                            items_( 0 ),
+                            bytes_( 0 )
+{
+  //
+  // Line align the slots by hand, operator new only guarantees 16 bytes
+  //
+  void*  pStorage = vStorage_.data( );
+  size_t uiSpace  = vStorage_.size( );
+
+  pStorage = std::align( STATS_LINE, ( STATS_OVERFLOW + 1 ) * sizeof( sStatsSlot_t ), pStorage, uiSpace );
+  pSlots_  = static_cast< sStatsSlot_t* >( pStorage );
+
+  for ( size_t i = 0; i <= STATS_OVERFLOW; i++ )
+  {
+    new ( &pSlots_[ i ] ) sStatsSlot_t( );
+  }
+
+  StatsRegistry::add( this );
+}
+
+//**********************************************************************************
+//
+//  ManagerStats::~ManagerStats
+//
+//  \brief DTOR, leaves the registry
+//
+//  Threads still holding pending counts for the manager drop them, one busy
+//  adding them is waited for
+//
+//  \return none
+//
+//**********************************************************************************
+ManagerStats::~ManagerStats( )
+{
+  StatsRegistry::remove( this );
+
+  std::lock_guard< std::mutex > lock( g_mThreads );
+
+  for ( size_t i = 0; i < STATS_OVERFLOW; i++ )
+  {
+    if ( g_apThreads[ i ] == nullptr )
+    {
+      continue;
+    }
+
+    std::atomic< uint64_t >& rSerial   = g_apThreads[ i ]->serial;
+    uint64_t                 u64Serial = rSerial.load( std::memory_order_acquire );
+
+    while ( u64Serial == BUSY_SERIAL ||
+            ( u64Serial == u64Serial_ && !rSerial.compare_exchange_weak( u64Serial, 0,
+                                                                         std::memory_order_acq_rel ) ) )
+    {
+      std::this_thread::yield( );
+      u64Serial = rSerial.load( std::memory_order_acquire );
+    }
+  }
+}
+
+//**********************************************************************************
+//
+//  ManagerStats::snapshot
+//
+//  \brief Sum every thread's slot and the counts threads still hold pending
+//
+//  Misses are read before lookups, a thread's miss is published after its
+//  lookup, so each thread adds at least as many lookups as misses
+//
+//  \return merged counters, histogram and gauges
+//
+//**********************************************************************************
+sStatsSnapshot_t ManagerStats::snapshot( ) const
+{
+  sStatsSnapshot_t sSnapshot = sStatsSnapshot_t( );
+  {
+    std::lock_guard< std::mutex > lock( g_mThreads );
+
+    for ( size_t i = 0; i < STATS_OVERFLOW; i++ )
+    {
+      const sStatsThread_t* pThread = g_apThreads[ i ];
+
+      if ( pThread == nullptr || pThread->serial.load( std::memory_order_acquire ) != u64Serial_ )
+      {
+        continue;
+      }
+
+      sSnapshot.counters[ STATS_MISSES  ] += pThread->misses.load( std::memory_order_acquire );
+      sSnapshot.counters[ STATS_LOOKUPS ] += pendingLookups( *pThread );
+    }
+  }
+
+  for ( size_t i = 0; i <= STATS_OVERFLOW; i++ )
+  {
+    const sStatsSlot_t& sSlot = pSlots_[ i ];
+
+    for ( size_t c = 0; c < STATS_COUNTERS; c++ )
+    {
+      sSnapshot.counters[ c ] += sSlot.counters[ c ].load( std::memory_order_relaxed );
+    }
+    for ( size_t b = 0; b < STATS_BUCKETS; b++ )
+    {
+      sSnapshot.latency[ b ] += sSlot.latency[ b ].load( std::memory_order_relaxed );
+    }
+  }
+
+  sSnapshot.items = items_.load( std::memory_order_relaxed );
+  sSnapshot.bytes = bytes_.load( std::memory_order_relaxed );
+  return sSnapshot;
+}
+
+//**********************************************************************************
+//
+//  ManagerStats::writeJson
+//
+//  \brief Write the merged stats as one JSON object
+//
+//  \param rOut stream to write to
+//
+//  The latency histogram is trimmed after its last non empty bucket, bucket i
+//  counts samples under 2^i timestamp counter ticks
+//
+//  \return none
+//
+//**********************************************************************************
+void ManagerStats::writeJson( std::ostream& rOut ) const
+{
+  sStatsSnapshot_t sSnapshot = snapshot( );
+  size_t           uiBuckets = STATS_BUCKETS;
+
+  while ( uiBuckets > 0 && sSnapshot.latency[ uiBuckets - 1 ] == 0 )
+  {
+    uiBuckets--;
+  }
+
+  rOut << "{\"name\":";
+  timing::writeJsonString( rOut, ssName_.c_str( ) );
+
+  for ( size_t c = 0; c < STATS_COUNTERS; c++ )
+  {
+    rOut << ",\"" << g_apCounterNames[ c ] << "\":" << sSnapshot.counters[ c ];
+  }
+
+  //
+  // Slots are read one after the other, a miss may be seen before its lookup
+  //
+  uint64_t u64Hits = sSnapshot.counters[ STATS_LOOKUPS ] > sSnapshot.counters[ STATS_MISSES ] ?
+                     sSnapshot.counters[ STATS_LOOKUPS ] - sSnapshot.counters[ STATS_MISSES ] : 0;
+
+  rOut << ",\"hits\":"  << u64Hits
+       << ",\"items\":" << sSnapshot.items
+       << ",\"bytes\":" << sSnapshot.bytes
+       << ",\"lookupTicksLog2\":[";
+
+  for ( size_t b = 0; b < uiBuckets; b++ )
+  {
+    rOut << ( b == 0 ? "" : "," ) << sSnapshot.latency[ b ];
+  }
+
+  rOut << "]}";
+}
+
+//**********************************************************************************
+//
+//  ManagerStats::registerThread
+//
+//  \brief Give the calling thread a slot index
+//
+//  Cold path taken on the first count of each thread, indices are recycled
+//  once their thread exits
+//
+//  \return index into every ManagerStats' slots
+//
+//**********************************************************************************
+uint32_t ManagerStats::registerThread( )
+{
+  static thread_local sThreadGuard sGuard;
+
+  uint32_t uiThread = static_cast< uint32_t >( STATS_OVERFLOW );
+  {
+    std::lock_guard< std::mutex > lock( g_mThreads );
+
+    if ( !g_vFreeThreads.empty( ) )
+    {
+      uiThread = g_vFreeThreads.back( );
+      g_vFreeThreads.pop_back( );
+    }
+    else if ( g_uiNextThread < STATS_OVERFLOW )
+    {
+      uiThread = g_uiNextThread++;
+    }
+
+    if ( uiThread < STATS_OVERFLOW )
+    {
+      g_apThreads[ uiThread ] = &threadLookups( );
+    }
+  }
+
+  sGuard.pThread    = &threadSlot( );
+  sGuard.pPending   = &threadLookups( );
+  sGuard.uiThread   = uiThread;
+  sGuard.uiOverflow = static_cast< uint32_t >( STATS_OVERFLOW );
+  threadSlot( )     = uiThread;
+  return uiThread;
+}
+
+//**********************************************************************************
+//
+//  ManagerStats::flushLookups
+//
+//  \brief Count a lookup startLookup( ) could not count inline
+//
+//  Taken on every COMPONENTS_STATS_SAMPLE'th lookup of a thread, which adds
+//  the pending counts to the slot and is timed, and when the thread looks up
+//  in another manager than the last one, which hands the pending counts to the
+//  previous one. Past COMPONENTS_STATS_THREADS threads every lookup comes here
+//  and goes to the shared overflow slot
+//
+//  \return start timestamp if the lookup is timed, otherwise 0
+//
+//**********************************************************************************
+uint64_t ManagerStats::flushLookups( )
+{
+  uint32_t        uiThread = thread( );
+  sStatsThread_t& sThread  = threadLookups( );
+
+  if ( uiThread >= STATS_OVERFLOW )
+  {
+    uint64_t u64Lookup = add( uiThread, pSlots_[ uiThread ].counters[ STATS_LOOKUPS ], 1 );
+    return ( u64Lookup % COMPONENTS_STATS_SAMPLE == 0 ) ? timing::readTsc( ) : 0;
+  }
+
+  if ( sThread.serial.load( std::memory_order_relaxed ) != u64Serial_ )
+  {
+    //
+    // The lookups since the last timed one carry over, so a thread alternating
+    // managers is still sampled
+    //
+    releaseLookups( sThread );
+    sThread.pCounters = pSlots_[ uiThread ].counters;
+    sThread.serial.store( u64Serial_, std::memory_order_relaxed );
+  }
+
+  uint32_t uiCountdown = sThread.countdown.load( std::memory_order_relaxed ) - 1;
+  sThread.countdown.store( uiCountdown, std::memory_order_relaxed );
+
+  if ( uiCountdown != 0 )
+  {
+    return 0;
+  }
+
+  handOver( sThread, true );
+  sThread.countdown.store( COMPONENTS_STATS_SAMPLE, std::memory_order_relaxed );
+  sThread.base     .store( COMPONENTS_STATS_SAMPLE, std::memory_order_relaxed );
+  return timing::readTsc( );
+}
+
+//**********************************************************************************
+//
+//  StatsRegistry::add
+//
+//  \brief Register live stats
+//
+//  \param pStats
+//
+//  \return none
+//
+//**********************************************************************************
+void StatsRegistry::add( ManagerStats* pStats )
+{
+  std::lock_guard< std::mutex > lock( g_mStats );
+  g_vStats.push_back( pStats );
+}
+
+//**********************************************************************************
+//
+//  StatsRegistry::remove
+//
+//  \brief Unregister stats about to be destroyed
+//
+//  \param pStats
+//
+//  \return none
+//
+//**********************************************************************************
+void StatsRegistry::remove( ManagerStats* pStats )
+{
+  std::lock_guard< std::mutex > lock( g_mStats );
+  g_vStats.erase( std::remove( g_vStats.begin( ), g_vStats.end( ), pStats ), g_vStats.end( ) );
+}
+
+//**********************************************************************************
+//
+//  StatsRegistry::size
+//
+//  \brief Number of managers reporting stats
+//
+//  \return count
+//
+//**********************************************************************************
+size_t StatsRegistry::size( )
+{
+  std::lock_guard< std::mutex > lock( g_mStats );
+  return g_vStats.size( );
+}
+
+//**********************************************************************************
+//
+//  StatsRegistry::snapshot
+//
+//  \brief Enumerate every live manager
+//
+//  \return name and merged stats of each, in creation order
+//
+//**********************************************************************************
+std::vector< std::pair< std::string, sStatsSnapshot_t > > StatsRegistry::snapshot( )
+{
+  std::lock_guard< std::mutex > lock( g_mStats );
+
+  std::vector< std::pair< std::string, sStatsSnapshot_t > > vSnapshots;
+  vSnapshots.reserve( g_vStats.size( ) );
+
+  for ( size_t i = 0; i < g_vStats.size( ); i++ )
+  {
+    vSnapshots.push_back( std::make_pair( g_vStats[ i ]->name( ), g_vStats[ i ]->snapshot( ) ) );
+  }
+
+  return vSnapshots;
+}
+
+//**********************************************************************************
+//
+//  StatsRegistry::writeJson
+//
+//  \brief Write every live manager's stats as JSON
+//
+//  \param rOut stream to write to
+//
+//  \return none
+//
+//**********************************************************************************
+void StatsRegistry::writeJson( std::ostream& rOut )
+{
+  std::lock_guard< std::mutex > lock( g_mStats );
+
+  rOut << "{\"managers\":[";
+
+  for ( size_t i = 0; i < g_vStats.size( ); i++ )
+  {
+    rOut << ( i == 0 ? "\n" : ",\n" );
+    g_vStats[ i ]->writeJson( rOut );
+  }
+
+  rOut << "\n]}\n";
+}
+
+//**********************************************************************************
+//
+//  StatsRegistry::dumpJson
+//
+//  \brief Write the stats to a file
+//
+//  \param ssPath path to the output .json
+//
+//  \return successful write
+//
+//**********************************************************************************
+bool StatsRegistry::dumpJson( const std::string& ssPath )
+{
+  std::ofstream ofFile( ssPath.c_str( ) );
+
+  if ( !ofFile.is_open( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " unable to open file \""
+                              << ssPath   << "\"" << std::endl;
+    return false;
+  }
+
+  writeJson( ofFile );
+  return ofFile.good( );
+}
+
+} // namespace resources
+
+} // namespace components
@@ -0,0 +1,320 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Stats.hpp
+//  Author  : Anthony Islas
+//  Purpose : Opt-in lookup and memory statistics for managers, and the registry
+//            of every live manager reporting them
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_STATS_H__
+#define __RESOURCES_STATS_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Profiler.hpp"
+
+//
+// Threads with a slot of their own in every ManagerStats, threads beyond that
+// share one slot and pay for an atomic add
+//
+#ifndef COMPONENTS_STATS_THREADS
+#define COMPONENTS_STATS_THREADS 64
+#endif
+
+//
+// One lookup in this many, per thread, has its latency measured
+//
+#ifndef COMPONENTS_STATS_SAMPLE
+#define COMPONENTS_STATS_SAMPLE 64
+#endif
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Hits are lookups - misses, so a hit costs a single counter update
+//
+typedef enum eStatsCounter
+{
+  STATS_LOOKUPS   = 0,
+  STATS_MISSES    = 1,
+  STATS_INSERTS   = 2,
+  STATS_EVICTIONS = 3,
+  STATS_COUNTERS  = 4
+} eStatsCounter_t;
+
+//
+// Latency bucket i counts sampled lookups taking under 2^i counter ticks
+//
+static const size_t STATS_BUCKETS = 32;
+
+typedef struct sStatsSnapshotStructure
+{
+  uint64_t counters[ STATS_COUNTERS ];
+  uint64_t latency [ STATS_BUCKETS  ];
+  uint64_t items;
+  uint64_t bytes;
+} sStatsSnapshot_t;
+
+//
+// Lookups and misses a thread has counted for the manager it last looked up in
+// and not yet added to its slot there, base - countdown lookups. Written by the
+// thread alone with relaxed load / store pairs, snapshots read them live and
+// the manager clears the serial on destruction
+//
+typedef struct sStatsThreadStructure
+{
+  std::atomic< uint64_t >  serial;
+  std::atomic< uint64_t >* pCounters;
+  std::atomic< uint32_t >  countdown;
+  std::atomic< uint32_t >  base;
+  std::atomic< uint32_t >  misses;
+} sStatsThread_t;
+
+//
+// Counters of one manager. Every thread owns a cache line aligned slot it
+// updates with plain relaxed load / store pairs, no lock prefix and no sharing,
+// and readers sum the slots. Lookups and misses are first counted in the
+// thread's sStatsThread_t, which readers sum as well, and added to its slot
+// every COMPONENTS_STATS_SAMPLE lookups, when the thread moves on to another
+// manager and when it exits. Resident items and bytes are gauges written by
+// the owning thread whenever the manager changes size.
+//
+// Not free: a lookup with stats on runs a serial compare and a countdown more,
+// which measured about 2.5 ns on a 6 ns lookup at 1K entries and about 20 to
+// 25% on lookups that miss cache ( ManagerBench, +stats column )
+//
+class ManagerStats
+{
+public:
+  explicit ManagerStats( const std::string& ssName );
+  virtual ~ManagerStats( );
+
+  const std::string& name( ) const { return ssName_; }
+
+  //
+  // Count a lookup. Every COMPONENTS_STATS_SAMPLE'th lookup of a thread is
+  // timed, it gets its start timestamp to pass to endLookup( ), the others 0
+  //
+  inline uint64_t startLookup( )
+  {
+    sStatsThread_t& sThread = threadLookups( );
+
+    if ( sThread.serial.load( std::memory_order_relaxed ) == u64Serial_ )
+    {
+      uint32_t uiCountdown = sThread.countdown.load( std::memory_order_relaxed ) - 1;
+
+      if ( uiCountdown != 0 )
+      {
+        sThread.countdown.store( uiCountdown, std::memory_order_relaxed );
+        return 0;
+      }
+    }
+
+    return flushLookups( );
+  }
+
+  //
+  // A miss is pending with its lookup, so a snapshot never has more misses
+  // than lookups from one thread
+  //
+  inline void endLookup( bool bHit, uint64_t u64Start )
+  {
+    if ( !bHit )
+    {
+      sStatsThread_t& sThread = threadLookups( );
+
+      if ( sThread.serial.load( std::memory_order_relaxed ) == u64Serial_ )
+      {
+        sThread.misses.store( sThread.misses.load( std::memory_order_relaxed ) + 1, std::memory_order_release );
+      }
+      else
+      {
+        count( STATS_MISSES, 1 );
+      }
+    }
+    if ( u64Start != 0 )
+    {
+      uint32_t uiThread = thread( );
+      add( uiThread, pSlots_[ uiThread ].latency[ bucketOf( timing::readTsc( ) - u64Start ) ], 1 );
+    }
+  }
+
+  inline void count( eStatsCounter_t eCounter, uint64_t u64Count )
+  {
+    if ( u64Count != 0 )
+    {
+      uint32_t uiThread = thread( );
+      add( uiThread, pSlots_[ uiThread ].counters[ eCounter ], u64Count );
+    }
+  }
+
+  inline void setResident( uint64_t u64Items, uint64_t u64Bytes )
+  {
+    items_.store( u64Items, std::memory_order_relaxed );
+    bytes_.store( u64Bytes, std::memory_order_relaxed );
+  }
+
+  //
+  // Safe while the manager is in use, counters may be mid update, a thread
+  // handing its pending counts to the slot may be missed for that moment
+  //
+  sStatsSnapshot_t snapshot ( ) const;
+  void             writeJson( std::ostream& rOut ) const;
+
+private:
+  static const size_t STATS_LINE     = 64;
+  static const size_t STATS_OVERFLOW = COMPONENTS_STATS_THREADS;
+
+  typedef struct sStatsSlotStructure
+  {
+    std::atomic< uint64_t > counters[ STATS_COUNTERS ];
+    std::atomic< uint64_t > latency [ STATS_BUCKETS  ];
+    char                    pad     [ STATS_LINE -
+                                      ( ( STATS_COUNTERS + STATS_BUCKETS ) * sizeof( uint64_t ) ) % STATS_LINE ];
+  } sStatsSlot_t;
+
+  ManagerStats( const ManagerStats& ) = delete;
+  ManagerStats& operator=( const ManagerStats& ) = delete;
+
+  //
+  // Defined in the header and constant initialized, so reading them is a
+  // thread pointer relative load rather than a call to the TLS wrapper of
+  // another translation unit
+  //
+  static inline uint32_t& threadSlot( )
+  {
+    static thread_local uint32_t uiThread = INVALID_THREAD;
+    return uiThread;
+  }
+
+  static inline sStatsThread_t& threadLookups( )
+  {
+    static thread_local sStatsThread_t sThread =
+    {
+      { 0 }, nullptr, { COMPONENTS_STATS_SAMPLE }, { COMPONENTS_STATS_SAMPLE }, { 0 }
+    };
+    return sThread;
+  }
+
+  static inline uint32_t thread( )
+  {
+    uint32_t uiThread = threadSlot( );
+    return ( uiThread == INVALID_THREAD ) ? registerThread( ) : uiThread;
+  }
+
+  //
+  // Returns the new value
+  //
+  static inline uint64_t add( uint32_t uiThread, std::atomic< uint64_t >& rCounter, uint64_t u64Count )
+  {
+    if ( uiThread < STATS_OVERFLOW )
+    {
+      uint64_t u64Value = rCounter.load( std::memory_order_relaxed ) + u64Count;
+      rCounter.store( u64Value, std::memory_order_relaxed );
+      return u64Value;
+    }
+
+    return rCounter.fetch_add( u64Count, std::memory_order_relaxed ) + u64Count;
+  }
+
+  static inline size_t bucketOf( uint64_t u64Ticks )
+  {
+    size_t uiBucket = 0;
+    while ( u64Ticks != 0 && uiBucket + 1 < STATS_BUCKETS )
+    {
+      u64Ticks >>= 1;
+      uiBucket++;
+    }
+    return uiBucket;
+  }
+
+  static const uint32_t INVALID_THREAD = 0xFFFFFFFF;
+
+  static uint32_t registerThread( );
+  uint64_t        flushLookups  ( );
+
+  const uint64_t          u64Serial_;
+  std::string             ssName_;
+  std::vector< char >     vStorage_;
+  sStatsSlot_t*           pSlots_;
+  std::atomic< uint64_t > items_;
+  std::atomic< uint64_t > bytes_;
+};
+
+//
+// Every live ManagerStats, in creation order
+//
+class StatsRegistry
+{
+public:
+  static size_t size( );
+
+  static std::vector< std::pair< std::string, sStatsSnapshot_t > > snapshot( );
+
+  //
+  // { "managers" : [ { "name" : ..., "hits" : ..., ... }, ... ] }
+  //
+  static void writeJson( std::ostream& rOut );
+  static bool dumpJson ( const std::string& ssPath );
+
+private:
+  friend class ManagerStats;
+
+  static void add   ( ManagerStats* pStats );
+  static void remove( ManagerStats* pStats );
+};
+
+//
+// Owner of a manager's stats. Managers are copied as values ( e.g. the shards
+// of ConcurrentManager ), a copy starts without stats rather than sharing a
+// name and counters with the original
+//
+class StatsHolder
+{
+public:
+  StatsHolder( ) { }
+  StatsHolder( const StatsHolder& ) { }
+  StatsHolder( StatsHolder&& other ) : pStats_( std::move( other.pStats_ ) ) { }
+
+  StatsHolder& operator=( const StatsHolder& ) { return *this; }
+  StatsHolder& operator=( StatsHolder&& other ) { pStats_ = std::move( other.pStats_ ); return *this; }
+
+  ManagerStats* get  ( ) const { return pStats_.get( ); }
+  void          reset( ManagerStats* pStats = nullptr ) { pStats_.reset( pStats ); }
+
+private:
+  std::unique_ptr< ManagerStats > pStats_;
+};
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_STATS_H__
@@ -0,0 +1,327 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Storage.hpp
+//  Author  : Anthony Islas
+//  Purpose : Item storage policies for Manager, inline in a dense vector or out
+//            of line in a slab pool
+//  Group   : Resources
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+#ifndef __RESOURCES_STORAGE_H__
+#define __RESOURCES_STORAGE_H__
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Pool.hpp"
+#include "Span.hpp"
+
+namespace components
+{
+
+namespace resources
+{
+
+//
+// Items by value in one vector, best for small items swept linearly. Erasing
+// moves the last item into the hole and growth moves every item
+//
+template< typename Item >
+class DenseStorage
+{
+public:
+  typedef Span< Item >       Range_t;
+  typedef Span< const Item > ConstRange_t;
+
+  Item&       operator[]( size_t i )       { return vItems_[ i ]; }
+  const Item& operator[]( size_t i ) const { return vItems_[ i ]; }
+  Item&       back      ( )                { return vItems_.back( ); }
+
+  size_t size   ( ) const          { return vItems_.size( );    }
+  void   reserve( size_t uiCount ) { vItems_.reserve( uiCount ); }
+  void   clear  ( )                { vItems_.clear( );          }
+
+  template< typename... Args >
+  void emplace_back( Args&&... args ) { vItems_.emplace_back( std::forward< Args >( args )... ); }
+
+  template< typename... Args >
+  void replace( size_t i, Args&&... args ) { vItems_[ i ] = Item( std::forward< Args >( args )... ); }
+
+  //
+  // Move the last item into i
+  //
+  void erase( size_t i )
+  {
+    if ( i + 1 != vItems_.size( ) )
+    {
+      vItems_[ i ] = std::move( vItems_.back( ) );
+    }
+    vItems_.pop_back( );
+  }
+
+  Range_t      view( )       { return Range_t( vItems_ );      }
+  ConstRange_t view( ) const { return ConstRange_t( vItems_ ); }
+
+private:
+  std::vector< Item > vItems_;
+};
+
+//
+// Items out of line in blocks of the per-type SlabPool, only pointers are kept
+// dense. Items never move, so large items are not copied on erase or growth,
+// and once the pool is warm adding and removing items does not touch the
+// global allocator. THREAD_CACHE routes blocks through the thread-local cache,
+// worth it when managers of the same type live on several threads
+//
+template< typename Item, bool THREAD_CACHE = false >
+class PooledStorage
+{
+public:
+  typedef SlabPool< Item >           Pool_t;
+  typedef IndirectSpan< Item >       Range_t;
+  typedef IndirectSpan< const Item > ConstRange_t;
+
+  PooledStorage( ) : pPool_( &Pool_t::shared( ) ) { }
+  PooledStorage( const PooledStorage& other );
+  PooledStorage& operator=( const PooledStorage& other );
+  ~PooledStorage( ) { clear( ); }
+
+  Item&       operator[]( size_t i )       { return *vItems_[ i ]; }
+  const Item& operator[]( size_t i ) const { return *vItems_[ i ]; }
+  Item&       back      ( )                { return *vItems_.back( ); }
+
+  size_t size   ( ) const          { return vItems_.size( );    }
+  void   reserve( size_t uiCount ) { vItems_.reserve( uiCount ); }
+  void   clear  ( );
+
+  template< typename... Args >
+  void emplace_back( Args&&... args );
+
+  template< typename... Args >
+  void replace( size_t i, Args&&... args );
+
+  //
+  // Destroy item i, the last pointer takes its place
+  //
+  void erase( size_t i );
+
+  Range_t      view( )       { return Range_t( vItems_.data( ), vItems_.size( ) );      }
+  ConstRange_t view( ) const { return ConstRange_t( vItems_.data( ), vItems_.size( ) ); }
+
+private:
+  template< typename... Args >
+  Item* construct( Args&&... args );
+  void  destroy  ( Item* pItem );
+
+  Pool_t*              pPool_;
+  std::vector< Item* > vItems_;
+};
+
+
+//**********************************************************************************
+//
+//  PooledStorage::PooledStorage
+//
+//  \brief Copy every item into blocks of its own
+//
+//  \param other
+//
+//  \return PooledStorage
+//
+//**********************************************************************************
+template< typename Item, bool THREAD_CACHE >
+PooledStorage< Item, THREAD_CACHE >::PooledStorage( const PooledStorage& other ) :
+                                      pPool_( other.pPool_ )
+{
+  vItems_.reserve( other.size( ) );
+
+  for ( size_t i = 0; i < other.size( ); i++ )
+  {
+    emplace_back( other[ i ] );
+  }
+}
+
+//**********************************************************************************
+//
+//  PooledStorage::operator=
+//
+//  \brief Replace every item with a copy of other's
+//
+//  \param other
+//
+//  \return *this
+//
+//**********************************************************************************
+template< typename Item, bool THREAD_CACHE >
+PooledStorage< Item, THREAD_CACHE >&
+PooledStorage< Item, THREAD_CACHE >::operator=( const PooledStorage& other )
+{
+  if ( this != &other )
+  {
+    PooledStorage copy( other );
+    clear( );
+    vItems_.swap( copy.vItems_ );
+  }
+
+  return *this;
+}
+
+//**********************************************************************************
+//
+//  PooledStorage::clear
+//
+//  \brief Destroy every item, the pointer array keeps its capacity
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, bool THREAD_CACHE >
+void PooledStorage< Item, THREAD_CACHE >::clear( )
+{
+  for ( size_t i = 0; i < vItems_.size( ); i++ )
+  {
+    destroy( vItems_[ i ] );
+  }
+
+  vItems_.clear( );
+}
+
+//**********************************************************************************
+//
+//  PooledStorage::emplace_back
+//
+//  \brief Construct an item in a pool block
+//
+//  \param args forwarded to Item's constructor
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, bool THREAD_CACHE >
+template< typename... Args >
+void PooledStorage< Item, THREAD_CACHE >::emplace_back( Args&&... args )
+{
+  vItems_.push_back( nullptr );
+
+  try
+  {
+    vItems_.back( ) = construct( std::forward< Args >( args )... );
+  }
+  catch ( ... )
+  {
+    vItems_.pop_back( );
+    throw;
+  }
+}
+
+//**********************************************************************************
+//
+//  PooledStorage::replace
+//
+//  \brief Construct a new item i, the old one is only destroyed once that
+//         succeeded
+//
+//  \param i    position
+//  \param args forwarded to Item's constructor
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, bool THREAD_CACHE >
+template< typename... Args >
+void PooledStorage< Item, THREAD_CACHE >::replace( size_t i, Args&&... args )
+{
+  Item* pItem = construct( std::forward< Args >( args )... );
+
+  destroy( vItems_[ i ] );
+  vItems_[ i ] = pItem;
+}
+
+//**********************************************************************************
+//
+//  PooledStorage::erase
+//
+//  \brief Destroy item i and fill the hole with the last pointer
+//
+//  \param i position
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, bool THREAD_CACHE >
+void PooledStorage< Item, THREAD_CACHE >::erase( size_t i )
+{
+  destroy( vItems_[ i ] );
+
+  vItems_[ i ] = vItems_.back( );
+  vItems_.pop_back( );
+}
+
+//**********************************************************************************
+//
+//  PooledStorage::construct
+//
+//  \brief Build an item in a fresh block
+//
+//  \param args forwarded to Item's constructor
+//
+//  \return item, the block is returned if the constructor throws
+//
+//**********************************************************************************
+template< typename Item, bool THREAD_CACHE >
+template< typename... Args >
+Item* PooledStorage< Item, THREAD_CACHE >::construct( Args&&... args )
+{
+  void* p = pPool_->allocate( THREAD_CACHE );
+
+  try
+  {
+    return new ( p ) Item( std::forward< Args >( args )... );
+  }
+  catch ( ... )
+  {
+    pPool_->deallocate( p, THREAD_CACHE );
+    throw;
+  }
+}
+
+//**********************************************************************************
+//
+//  PooledStorage::destroy
+//
+//  \brief Destroy an item and return its block
+//
+//  \param pItem
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Item, bool THREAD_CACHE >
+void PooledStorage< Item, THREAD_CACHE >::destroy( Item* pItem )
+{
+  pItem->~Item( );
+  pPool_->deallocate( pItem, THREAD_CACHE );
+}
+
+} // namespace resources
+
+} // namespace components
+
+#endif // __RESOURCES_STORAGE_H__
@@ -29,6 +29,7 @@
 
 #include "strutils.hpp"
 #include "Parser.hpp"
+#include "Profiler.hpp"
 
 namespace components
 {
@@ -71,12 +72,35 @@ Parser::~Parser( ) { };
 //  The parser does not go beyond scoping of elements, after that it is up to the 
 //  application specific implementation 
 //
-//  return A set of parsed elements
+//  return A set of parsed elements, empty if the file could not be opened
 //
 //**********************************************************************************
 sParseElement_t Parser::ParseFile ( std::string ssPath )
 {
-  sParseElement_t            sMainElem;
+  sParseElement_t sMainElem;
+
+  ParseFile( ssPath, sMainElem );
+
+  return sMainElem;
+}
+
+//**********************************************************************************
+//
+//  File parser
+//
+//  ssPath    is the path ( relative or absolute ) to the file to parse
+//  sMainElem receives the parsed elements
+//
+//  The file is opened once, callers needing to know it was readable check the
+//  return instead of opening it beforehand
+//
+//  return false if the file could not be opened
+//
+//**********************************************************************************
+bool Parser::ParseFile ( std::string ssPath, sParseElement_t& sMainElem )
+{
+  PROFILE_SCOPE( "Parser::ParseFile" );
+
   std::vector< std::string > vLines;
   std::ifstream              ifFile ( ssPath.c_str() );
 
@@ -112,10 +136,11 @@ sParseElement_t Parser::ParseFile ( std::string ssPath )
     std::cerr << "Error at: " << __FILE__ << ":" 
                               << __LINE__ << " unable to open file \"" 
                               << ssPath   << "\"";
+    return false;
   }
 
 
-  return sMainElem;
+  return true;
 }
 
 //**********************************************************************************
@@ -95,6 +95,11 @@ class Parser
     virtual ~Parser( );
 
     sParseElement_t ParseFile ( std::string ssPath );
+
+    //
+    // Same, tells an unreadable file apart from an empty one
+    //
+    bool ParseFile ( std::string ssPath, sParseElement_t& sMainElem );
 };
 
 
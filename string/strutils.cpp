@@ -23,6 +23,7 @@
 ////////////////////////////////////////////////////////////////////////////////////
 
 #include "strutils.hpp"
+#include "Profiler.hpp"
 
 namespace components
 {
@@ -50,6 +51,8 @@ void split( char cDelim,
             std::vector< std::string > &rvElems, 
             bool bRemoveDelim ) 
 {
+    PROFILE_SCOPE( "split" );
+
     std::stringstream ss;
     ss.str(s);
     std::string item;
@@ -22,7 +22,12 @@
 //
 ////////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
 #include "Clock.hpp"
+#include "Profiler.hpp"
 
 namespace components
 {
@@ -30,8 +35,623 @@ namespace components
 namespace timing
 {
 
+//**********************************************************************************
+//
+//  Clock::Clock
+//
+//  \brief Generic clock, defaults to 60Hz
+//
+//  \return Clock
+//
+//**********************************************************************************
+Clock::Clock( ) :
+              fp64Delay_( 1000.0 / 60.0 ),
+              fp64Freq_ ( 60.0          ),
+              fp64Lead_ ( 1.0           ),
+              bQuiet_   ( false         ),
+              tick_     ( 0             ),
+              released_ ( 0             ),
+              running_  ( false         )
+{ }
+
+//**********************************************************************************
+//
+//  Clock::~Clock
+//
+//  \brief DTOR, stops the clock and joins all stage threads
+//
+//  \return none
+//
+//**********************************************************************************
+Clock::~Clock( )
+{
+  stop( );
+}
+
+//**********************************************************************************
+//
+//  Clock::setFrequency
+//
+//  \brief Set tick rate
+//
+//  \param fp64Freq ticks per second
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::setFrequency( double fp64Freq )
+{
+  if ( fp64Freq > 0.0 )
+  {
+    fp64Freq_  = fp64Freq;
+    fp64Delay_ = 1000.0 / fp64Freq;
+  }
+}
+
+//**********************************************************************************
+//
+//  Clock::setTimeMilli
+//
+//  \brief Set tick period
+//
+//  \param fp64Delay milliseconds between ticks
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::setTimeMilli( double fp64Delay )
+{
+  if ( fp64Delay > 0.0 )
+  {
+    fp64Delay_ = fp64Delay;
+    fp64Freq_  = 1000.0 / fp64Delay;
+  }
+}
+
+//**********************************************************************************
+//
+//  Clock::setLeadMilli
+//
+//  \brief Set how early listeners prepare the next tick
+//
+//  \param fp64Lead milliseconds before each deadline beforeTick( ) runs at,
+//                  capped to half the period
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::setLeadMilli( double fp64Lead )
+{
+  if ( fp64Lead >= 0.0 )
+  {
+    fp64Lead_ = fp64Lead;
+  }
+}
+
+//**********************************************************************************
+//
+//  Clock::registerResource
+//
+//  \brief Tie a resource to this clock
+//
+//  \param m_Resource mutex the resource holds while it is not ready to update
+//  \param order      resources are acquired in ascending order each tick
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::registerResource( std::mutex& m_Resource, unsigned int order )
+{
+  if ( isRunning( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " cannot register while running"
+                              << std::endl;
+    return;
+  }
+
+  std::pair< unsigned int, std::mutex* > resource( order, &m_Resource );
+
+  vMutexResources_.insert(
+    std::upper_bound( vMutexResources_.begin( ), vMutexResources_.end( ), resource,
+                      []( const std::pair< unsigned int, std::mutex* >& a,
+                          const std::pair< unsigned int, std::mutex* >& b )
+                      { return a.first < b.first; } ),
+    resource );
+}
+
+//**********************************************************************************
+//
+//  Clock::registerStage
+//
+//  \brief Add a pipelined stage
+//
+//  \param stage stage to drive, must outlive the clock or its stop( )
+//  \param order stages are started in ascending order
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::registerStage( Stage& stage, unsigned int order )
+{
+  if ( isRunning( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " cannot register while running"
+                              << std::endl;
+    return;
+  }
+
+  std::unique_ptr< sStage_t > pStage( new sStage_t );
+  pStage->pStage = &stage;
+  pStage->order  = order;
+  pStage->completed.store( 0, std::memory_order_relaxed );
+
+  std::vector< std::unique_ptr< sStage_t > >::iterator it = vStages_.begin( );
+  while ( it != vStages_.end( ) && ( *it )->order <= order )
+  {
+    it++;
+  }
+  vStages_.insert( it, std::move( pStage ) );
+}
+
+//**********************************************************************************
+//
+//  Clock::registerListener
+//
+//  \brief Add hooks around every tick, holding the stages that read what they
+//         write
+//
+//  \param listener must outlive the clock or its stop( )
+//  \param vHeld    stages kept between ticks while the hooks run, the others
+//                  keep overlapping ticks
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::registerListener( TickListener& listener, const std::vector< Stage* >& vHeld )
+{
+  if ( isRunning( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " cannot register while running"
+                              << std::endl;
+    return;
+  }
+
+  vListeners_.push_back( &listener );
+  vHeld_.insert( vHeld_.end( ), vHeld.begin( ), vHeld.end( ) );
+}
+
+//**********************************************************************************
+//
+//  Clock::registerListener
+//
+//  \brief Add hooks around every tick
+//
+//  \param listener must outlive the clock or its stop( )
+//  \param bQuiet   hold every stage while the hooks run, serializes the stages
+//                  as no stage starts a tick before all completed the last one
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::registerListener( TickListener& listener, bool bQuiet )
+{
+  if ( isRunning( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " cannot register while running"
+                              << std::endl;
+    return;
+  }
+
+  vListeners_.push_back( &listener );
+  bQuiet_ = bQuiet_ || bQuiet;
+}
+
+//**********************************************************************************
+//
+//  Clock::start
+//
+//  \brief Start ticking, spawns one thread per stage plus the clock thread
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::start( )
+{
+  if ( running_.exchange( true ) )
+  {
+    return;
+  }
+
+  for ( size_t i = 0; i < vChannels_.size( ); i++ )
+  {
+    vChannels_[ i ]->open( );
+  }
+
+  //
+  // Held stages catch up to the current tick, hooks start with the next one
+  //
+  released_.store( ticks( ), std::memory_order_release );
+
+  for ( size_t i = 0; i < vStages_.size( ); i++ )
+  {
+    sStage_t& sStage = *vStages_[ i ];
+    sStage.bHeld  = bQuiet_ ||
+                    std::find( vHeld_.begin( ), vHeld_.end( ), sStage.pStage ) != vHeld_.end( );
+    sStage.thread = std::thread( &Clock::runStage, this, std::ref( sStage ) );
+  }
+
+  thread_ = std::thread( &Clock::run, this );
+}
+
+//**********************************************************************************
+//
+//  Clock::stop
+//
+//  \brief Stop ticking and join all threads
+//
+//  Channels are closed so stages blocked on a port return, data still queued
+//  is kept for the next start( )
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::stop( )
+{
+  if ( !running_.exchange( false ) )
+  {
+    return;
+  }
+
+  for ( size_t i = 0; i < vChannels_.size( ); i++ )
+  {
+    vChannels_[ i ]->close( );
+  }
+
+  {
+    std::lock_guard< std::mutex > lock( mTick_ );
+    cvTick_.notify_all( );
+  }
+  {
+    std::lock_guard< std::mutex > lock( mDone_ );
+    cvDone_.notify_all( );
+  }
+
+  thread_.join( );
+
+  for ( size_t i = 0; i < vStages_.size( ); i++ )
+  {
+    vStages_[ i ]->thread.join( );
+  }
+}
+
+//**********************************************************************************
+//
+//  Clock::run
+//
+//  \brief Clock thread, fires update( ) every period
+//
+//  Deadlines are absolute so a slow tick does not push every following one.
+//  Listeners get the gap between the held stages completing a tick and the
+//  next deadline, afterTick( ) as soon as the stages are done so the work it
+//  starts has the whole gap, beforeTick( ) a lead ahead of the deadline. Held
+//  stages running late never delay the tick for the others, their hooks and
+//  release then follow the publish
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::run( )
+{
+  std::chrono::steady_clock::duration period =
+    std::chrono::duration_cast< std::chrono::steady_clock::duration >(
+      std::chrono::duration< double, std::milli >( fp64Delay_ ) );
+
+  std::chrono::steady_clock::duration lead =
+    std::chrono::duration_cast< std::chrono::steady_clock::duration >(
+      std::chrono::duration< double, std::milli >( std::min( fp64Lead_, fp64Delay_ / 2.0 ) ) );
+
+  std::chrono::steady_clock::time_point next = std::chrono::steady_clock::now( );
+
+  uint64_t u64After = ticks( );
+
+  while ( isRunning( ) )
+  {
+    next += period;
+
+    uint64_t u64Tick = ticks( ) + 1;
+
+    if ( !vListeners_.empty( ) && drainTick( u64Tick - 1, next ) )
+    {
+      listen( u64Tick, u64After, next - lead );
+    }
+
+    std::this_thread::sleep_until( next );
+
+    if ( !isRunning( ) )
+    {
+      break;
+    }
+
+    update( );
+
+    if ( vListeners_.empty( ) || released_.load( std::memory_order_acquire ) >= u64Tick )
+    {
+      continue;
+    }
+
+    if ( !drainTick( u64Tick - 1 ) )
+    {
+      break;
+    }
+
+    listen( u64Tick, u64After, std::chrono::steady_clock::now( ) );
+  }
+}
+
+//**********************************************************************************
+//
+//  Clock::listen
+//
+//  \brief Run the hooks for the gap before a tick, held stages are between ticks
+//
+//  \param u64Tick  tick about to start
+//  \param u64After last tick given to afterTick( ), advanced
+//  \param deadline beforeTick( ) runs then, afterTick( ) until then for every
+//                  tick the stages complete
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::listen( uint64_t                              u64Tick,
+                    uint64_t&                             u64After,
+                    std::chrono::steady_clock::time_point deadline )
+{
+  PROFILE_SCOPE( "Clock::listeners" );
+
+  std::unique_lock< std::mutex > lock( mDone_ );
+
+  while ( isRunning( ) )
+  {
+    uint64_t u64Done = completedTicks( false );
+
+    if ( u64After < u64Done )
+    {
+      lock.unlock( );
+      for ( ; u64After < u64Done; u64After++ )
+      {
+        for ( size_t i = 0; i < vListeners_.size( ); i++ )
+        {
+          vListeners_[ i ]->afterTick( u64After + 1 );
+        }
+      }
+      lock.lock( );
+      continue;
+    }
+
+    if ( cvDone_.wait_until( lock, deadline ) == std::cv_status::timeout )
+    {
+      break;
+    }
+  }
+
+  lock.unlock( );
+
+  if ( !isRunning( ) )
+  {
+    return;
+  }
+
+  for ( size_t i = 0; i < vListeners_.size( ); i++ )
+  {
+    vListeners_[ i ]->beforeTick( u64Tick );
+  }
+
+  release( u64Tick );
+}
+
+//**********************************************************************************
+//
+//  Clock::release
+//
+//  \brief Let held stages start a tick
+//
+//  \param u64Tick
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::release( uint64_t u64Tick )
+{
+  std::lock_guard< std::mutex > lock( mTick_ );
+  released_.store( u64Tick, std::memory_order_release );
+  cvTick_.notify_all( );
+}
+
+//**********************************************************************************
+//
+//  Clock::drainTick
+//
+//  \brief Wait for every held stage to complete a tick
+//
+//  \param u64Tick
+//
+//  \return false if the clock was stopped while waiting
+//
+//**********************************************************************************
+bool Clock::drainTick( uint64_t u64Tick )
+{
+  std::unique_lock< std::mutex > lock( mDone_ );
+
+  cvDone_.wait( lock, [ & ]( )
+                {
+                  return !isRunning( ) || completedTicks( true ) >= u64Tick;
+                } );
+
+  return isRunning( );
+}
+
+//**********************************************************************************
+//
+//  Clock::drainTick
+//
+//  \brief Wait for every held stage to complete a tick, up to a deadline
+//
+//  \param u64Tick
+//  \param deadline
+//
+//  \return true if they did while the clock runs
+//
+//**********************************************************************************
+bool Clock::drainTick( uint64_t u64Tick, std::chrono::steady_clock::time_point deadline )
+{
+  std::unique_lock< std::mutex > lock( mDone_ );
+
+  bool bDone = cvDone_.wait_until( lock, deadline, [ & ]( )
+                                   {
+                                     return !isRunning( ) || completedTicks( true ) >= u64Tick;
+                                   } );
+
+  return bDone && isRunning( );
+}
+
+//**********************************************************************************
+//
+//  Clock::readyTick
+//
+//  \brief Latest tick a stage may start
+//
+//  \param sStage
+//
+//  \return published tick, or the released one for held stages
+//
+//**********************************************************************************
+uint64_t Clock::readyTick( const sStage_t& sStage ) const
+{
+  uint64_t u64Tick = tick_.load( std::memory_order_acquire );
+
+  if ( sStage.bHeld )
+  {
+    u64Tick = std::min( u64Tick, released_.load( std::memory_order_acquire ) );
+  }
+
+  return u64Tick;
+}
+
+//**********************************************************************************
+//
+//  Clock::completedTicks
+//
+//  \brief Latest tick every stage has completed, without waiting
+//
+//  \param bHeld only look at held stages
+//
+//  \return tick, the current one when there are no such stages
+//
+//**********************************************************************************
+uint64_t Clock::completedTicks( bool bHeld ) const
+{
+  uint64_t u64Done = ticks( );
+
+  for ( size_t i = 0; i < vStages_.size( ); i++ )
+  {
+    if ( !bHeld || vStages_[ i ]->bHeld )
+    {
+      u64Done = std::min( u64Done, vStages_[ i ]->completed.load( std::memory_order_acquire ) );
+    }
+  }
+
+  return u64Done;
+}
+
+//**********************************************************************************
+//
+//  Clock::update
+//
+//  \brief Publish a single tick
+//
+//  Lock-step resources are acquired in order so the tick only fires once all of
+//  them are ready, pipelined stages are then woken for the new tick
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::update( )
+{
+  PROFILE_SCOPE( "Clock::tick" );
+
+  for ( size_t i = 0; i < vMutexResources_.size( ); i++ )
+  {
+    vMutexResources_[ i ].second->lock( );
+  }
+
+  tick_.fetch_add( 1, std::memory_order_acq_rel );
+
+  {
+    std::lock_guard< std::mutex > lock( mTick_ );
+    cvTick_.notify_all( );
+  }
+
+  for ( size_t i = vMutexResources_.size( ); i > 0; i-- )
+  {
+    vMutexResources_[ i - 1 ].second->unlock( );
+  }
+}
+
+//**********************************************************************************
+//
+//  Clock::runStage
+//
+//  \brief Stage thread, processes every tick in order
+//
+//  \param sStage stage to drive
+//
+//  A stage that falls behind runs its missed ticks back to back, it is only
+//  held back by its own ports and, when a listener holds it, by the hooks
+//
+//  \return none
+//
+//**********************************************************************************
+void Clock::runStage( sStage_t& sStage )
+{
+  uint64_t u64Next = sStage.completed.load( std::memory_order_relaxed ) + 1;
+
+  while ( isRunning( ) )
+  {
+    if ( readyTick( sStage ) < u64Next )
+    {
+      std::unique_lock< std::mutex > lock( mTick_ );
+      cvTick_.wait( lock, [ & ]( )
+                    {
+                      return !isRunning( ) || readyTick( sStage ) >= u64Next;
+                    } );
+      if ( !isRunning( ) )
+      {
+        break;
+      }
+    }
+
+    {
+#ifdef COMPONENTS_PROFILE
+      ScopedTimer timer( sStage.pStage->name( ) );
+#endif
+      sStage.pStage->process( u64Next );
+    }
+
+    sStage.completed.store( u64Next, std::memory_order_release );
+    u64Next++;
 
+    if ( !vListeners_.empty( ) )
+    {
+      std::lock_guard< std::mutex > lock( mDone_ );
+      cvDone_.notify_one( );
+    }
+  }
+}
 
 } // namespace timing
 
-} // namespace components
\ No newline at end of file
+} // namespace components
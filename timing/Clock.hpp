@@ -27,12 +27,45 @@
 #ifndef __TIMING_CLOCK_H__
 #define __TIMING_CLOCK_H__
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "Dataflow.hpp"
+
 namespace components
 {
 
 namespace timing
 {
-  
+
+//
+// Hooks around each tick, run on the clock thread while the stages a listener
+// holds are between ticks, so the hooks may touch state those stages read
+// without locking it
+//
+class TickListener
+{
+public:
+  virtual ~TickListener( ) { }
+
+  //
+  // Idle gap before u64Tick is published, shortly before its deadline
+  //
+  virtual void beforeTick( uint64_t u64Tick ) { ( void )u64Tick; }
+
+  //
+  // Every stage has completed u64Tick
+  //
+  virtual void afterTick ( uint64_t u64Tick ) { ( void )u64Tick; }
+};
+
 class Clock
 {
 public:
@@ -42,22 +75,171 @@ public:
   void setFrequency( double fp64Freq );
   void setTimeMilli( double fp64Delay );
 
-  void registerResource( std::mutex& m_Resource, unsigned int order )
+  //
+  // How long before a tick's deadline beforeTick( ) runs, at most half a period
+  //
+  void setLeadMilli( double fp64Lead );
+
+  //
+  // Lock-step resource, held by the clock while the tick is published
+  //
+  void registerResource( std::mutex& m_Resource, unsigned int order );
+
+  //
+  // Pipelined stage, run on its own thread once per tick. Stages only couple
+  // through their ports, so stage N may already be on tick T + 1 while stage
+  // N + 1 consumes the output of tick T
+  //
+  void registerStage( Stage& stage, unsigned int order );
+
+  //
+  // Called in registration order. afterTick( T ) runs once every stage has
+  // completed T, beforeTick( T ) shortly before T's deadline. The stages in
+  // vHeld are held between ticks around the hooks, a held stage only starts T
+  // once every beforeTick( T ) returned and the hooks only run once it
+  // completed T - 1. The other stages are never waited on and stay pipelined
+  //
+  void registerListener( TickListener& listener, const std::vector< Stage* >& vHeld );
+
+  //
+  // WARNING: a quiet listener holds every stage, which serializes the whole
+  // pipeline, no stage starts T + 1 before all of them completed T. Prefer
+  // holding only the stages that read what the listener writes
+  //
+  void registerListener( TickListener& listener, bool bQuiet );
+
+  //
+  // Join output -> input with a single producer / single consumer queue
+  //
+  template< typename T >
+  void connect( OutputPort< T >& out, InputPort< T >& in, size_t uiCapacity );
+
+  //
+  // Fan several outputs into one input with a multi producer queue
+  //
+  template< typename T >
+  void connect( const std::vector< OutputPort< T >* >& vOut,
+                InputPort< T >&                        in,
+                size_t                                 uiCapacity );
+
+  void start( );
+  void stop ( );
+
+  bool     isRunning( ) const { return running_.load( std::memory_order_acquire ); }
+  uint64_t ticks    ( ) const { return tick_.load( std::memory_order_acquire ); }
 
 private:
 
-  void update( );
+  typedef struct sStageStructure
+  {
+    Stage*                  pStage;
+    unsigned int            order;
+    bool                    bHeld;
+    std::thread             thread;
+    std::atomic< uint64_t > completed;
+  } sStage_t;
+
+  void     update        ( );
+  void     run           ( );
+  void     runStage      ( sStage_t& sStage );
+  bool     drainTick     ( uint64_t u64Tick );
+  bool     drainTick     ( uint64_t u64Tick, std::chrono::steady_clock::time_point deadline );
+  void     listen        ( uint64_t u64Tick, uint64_t& u64After,
+                           std::chrono::steady_clock::time_point deadline );
+  void     release       ( uint64_t u64Tick );
+  uint64_t readyTick     ( const sStage_t& sStage ) const;
+  uint64_t completedTicks( bool bHeld ) const;
 
   double fp64Delay_;
   double fp64Freq_;
+  double fp64Lead_;
 
-  std::vector< std::mutex& > vMutexResources;
+  std::vector< std::pair< unsigned int, std::mutex* > > vMutexResources_;
+  std::vector< std::unique_ptr< sStage_t > >            vStages_;
+  std::vector< std::shared_ptr< ChannelBase > >         vChannels_;
+  std::vector< TickListener* >                          vListeners_;
+  std::vector< Stage* >                                 vHeld_;
+  bool                                                  bQuiet_;
 
+  std::atomic< uint64_t > tick_;
+
+  //
+  // Latest tick held stages may start, trails tick_ while hooks are late
+  //
+  std::atomic< uint64_t > released_;
+  std::atomic< bool >     running_;
+  std::thread             thread_;
+
+  //
+  // Wakes stage threads waiting on the next tick
+  //
+  std::mutex              mTick_;
+  std::condition_variable cvTick_;
+
+  //
+  // Wakes the clock thread waiting on stages to complete a tick
+  //
+  std::mutex              mDone_;
+  std::condition_variable cvDone_;
 
 };
 
+
+//**********************************************************************************
+//
+//  Clock::connect
+//
+//  \brief Connect two stage ports
+//
+//  \param out        producer port
+//  \param in         consumer port
+//  \param uiCapacity elements buffered before the producer is pushed back on
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename T >
+void Clock::connect( OutputPort< T >& out, InputPort< T >& in, size_t uiCapacity )
+{
+  std::shared_ptr< Channel< T > > pChannel(
+    new QueueChannel< T, SpscQueue< T > >( uiCapacity ) );
+
+  out.attach( pChannel );
+  in .attach( pChannel );
+  vChannels_.push_back( pChannel );
+}
+
+//**********************************************************************************
+//
+//  Clock::connect
+//
+//  \brief Connect several producer ports to one consumer port
+//
+//  \param vOut       producer ports
+//  \param in         consumer port
+//  \param uiCapacity elements buffered before producers are pushed back on
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename T >
+void Clock::connect( const std::vector< OutputPort< T >* >& vOut,
+                     InputPort< T >&                        in,
+                     size_t                                 uiCapacity )
+{
+  std::shared_ptr< Channel< T > > pChannel(
+    new QueueChannel< T, MpmcQueue< T > >( uiCapacity ) );
+
+  for ( size_t i = 0; i < vOut.size( ); i++ )
+  {
+    vOut[ i ]->attach( pChannel );
+  }
+  in.attach( pChannel );
+  vChannels_.push_back( pChannel );
+}
+
 } // namespace timing
 
 } // namespace components
 
-#endif // __TIMING_CLOCK_H__
\ No newline at end of file
+#endif // __TIMING_CLOCK_H__
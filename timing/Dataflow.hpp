@@ -0,0 +1,311 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Dataflow.hpp
+//  Author  : Anthony Islas
+//  Purpose : Stages and typed ports moving data between stages of a Clock, ports
+//            are joined by bounded queues so a full queue pushes back on its
+//            producer
+//  Group   : Timing
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __TIMING_DATAFLOW_H__
+#define __TIMING_DATAFLOW_H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "Queue.hpp"
+
+//
+// Attempts a blocking push / pop makes, yielding in between, before the port
+// sleeps on its channel until the other end moves or the channel closes
+//
+#ifndef COMPONENTS_DATAFLOW_SPIN
+#define COMPONENTS_DATAFLOW_SPIN 64
+#endif
+
+namespace components
+{
+
+namespace timing
+{
+
+//
+// Untyped view of a channel so the Clock can close them all on stop. Ports that
+// cannot make progress sleep on the channel, the other end wakes them after each
+// push or pop, which only costs a fence and a load while nobody sleeps
+//
+class ChannelBase
+{
+public:
+  ChannelBase( ) : closed_( false ), waiters_( 0 ) { }
+  virtual ~ChannelBase( ) { }
+
+  void open    ( )       { closed_.store( false, std::memory_order_release ); }
+  void close   ( );
+  bool isClosed( ) const { return closed_.load( std::memory_order_acquire ); }
+
+  inline void wake( );
+
+  //
+  // Spin, then sleep, until bReady( ) succeeds or the channel closes
+  //
+  template< typename Ready >
+  bool wait( Ready bReady );
+
+private:
+  std::atomic< bool >     closed_;
+  std::atomic< uint32_t > waiters_;
+  std::mutex              mWait_;
+  std::condition_variable cvWait_;
+};
+
+//
+// Typed channel between an output and an input port
+//
+template< typename T >
+class Channel : public ChannelBase
+{
+public:
+  virtual bool tryPush( T&& value ) = 0;
+  virtual bool tryPop ( T& rValue ) = 0;
+};
+
+//
+// Channel backed by one of the bounded queues ( SpscQueue or MpmcQueue )
+//
+template< typename T, typename Queue >
+class QueueChannel : public Channel< T >
+{
+public:
+  explicit QueueChannel( size_t uiCapacity ) : queue_( uiCapacity ) { }
+
+  bool tryPush( T&& value ) { return queue_.tryPush( std::move( value ) ); }
+  bool tryPop ( T& rValue ) { return queue_.tryPop( rValue ); }
+
+private:
+  Queue queue_;
+};
+
+//
+// Producer end, owned by the stage that writes
+//
+template< typename T >
+class OutputPort
+{
+public:
+  bool isConnected( ) const { return pChannel_ != nullptr; }
+
+  //
+  // Non-blocking, false when the consumer is behind or the channel is closed
+  //
+  bool tryPush( T value )
+  {
+    if ( pChannel_->isClosed( ) || !pChannel_->tryPush( std::move( value ) ) )
+    {
+      return false;
+    }
+    pChannel_->wake( );
+    return true;
+  }
+
+  //
+  // Blocks while the channel is full ( back-pressure ), false once closed
+  //
+  bool push( T value )
+  {
+    Channel< T >* pChannel = pChannel_.get( );
+
+    //
+    // Closed is checked before each attempt, a closed channel with room left
+    // must still refuse the element
+    //
+    if ( !pChannel->wait( [ pChannel, &value ]( )
+                          {
+                            return !pChannel->isClosed( ) &&
+                                   pChannel->tryPush( std::move( value ) );
+                          } ) )
+    {
+      return false;
+    }
+    pChannel->wake( );
+    return true;
+  }
+
+  void attach( const std::shared_ptr< Channel< T > >& pChannel ) { pChannel_ = pChannel; }
+
+private:
+  std::shared_ptr< Channel< T > > pChannel_;
+};
+
+//
+// Consumer end, owned by the stage that reads
+//
+template< typename T >
+class InputPort
+{
+public:
+  bool isConnected( ) const { return pChannel_ != nullptr; }
+
+  bool tryPop( T& rValue )
+  {
+    if ( !pChannel_->tryPop( rValue ) )
+    {
+      return false;
+    }
+    pChannel_->wake( );
+    return true;
+  }
+
+  //
+  // Blocks until upstream produces, false once closed and drained
+  //
+  bool pop( T& rValue )
+  {
+    Channel< T >* pChannel = pChannel_.get( );
+
+    if ( !pChannel->wait( [ pChannel, &rValue ]( ) { return pChannel->tryPop( rValue ); } ) &&
+         !pChannel->tryPop( rValue ) )
+    {
+      return false;
+    }
+    pChannel->wake( );
+    return true;
+  }
+
+  void attach( const std::shared_ptr< Channel< T > >& pChannel ) { pChannel_ = pChannel; }
+
+private:
+  std::shared_ptr< Channel< T > > pChannel_;
+};
+
+//
+// Unit of work driven by a Clock on its own thread, once per tick. A stage reads
+// its InputPorts and writes its OutputPorts inside process( )
+//
+class Stage
+{
+public:
+  virtual ~Stage( ) { }
+
+  virtual void process( uint64_t u64Tick ) = 0;
+
+  //
+  // Scope name used when profiling is enabled, must outlive the trace dump
+  //
+  virtual const char* name( ) const { return "Clock::stage"; }
+};
+
+
+//**********************************************************************************
+//
+//  ChannelBase::close
+//
+//  \brief Refuse further pushes and wake every sleeping port
+//
+//  \return none
+//
+//**********************************************************************************
+inline void ChannelBase::close( )
+{
+  closed_.store( true, std::memory_order_release );
+
+  std::lock_guard< std::mutex > lock( mWait_ );
+  cvWait_.notify_all( );
+}
+
+//**********************************************************************************
+//
+//  ChannelBase::wake
+//
+//  \brief Wake ports sleeping on the channel after a push or pop
+//
+//  The fence pairs with the one in wait( ), either the sleeper sees the element
+//  or the slot this thread moved, or this thread sees it registered
+//
+//  \return none
+//
+//**********************************************************************************
+inline void ChannelBase::wake( )
+{
+  std::atomic_thread_fence( std::memory_order_seq_cst );
+
+  if ( waiters_.load( std::memory_order_relaxed ) != 0 )
+  {
+    std::lock_guard< std::mutex > lock( mWait_ );
+    cvWait_.notify_all( );
+  }
+}
+
+//**********************************************************************************
+//
+//  ChannelBase::wait
+//
+//  \brief Retry an operation until it succeeds or the channel closes
+//
+//  \param bReady push or pop attempt, true on success
+//
+//  A stage waiting out a tick would otherwise hold a core, the spin only covers
+//  the other end being a few instructions behind
+//
+//  \return false once closed without bReady( ) succeeding
+//
+//**********************************************************************************
+template< typename Ready >
+bool ChannelBase::wait( Ready bReady )
+{
+  for ( size_t i = 0; i < COMPONENTS_DATAFLOW_SPIN; i++ )
+  {
+    if ( bReady( ) )
+    {
+      return true;
+    }
+    if ( isClosed( ) )
+    {
+      return false;
+    }
+    std::this_thread::yield( );
+  }
+
+  std::unique_lock< std::mutex > lock( mWait_ );
+
+  waiters_.fetch_add( 1, std::memory_order_relaxed );
+  std::atomic_thread_fence( std::memory_order_seq_cst );
+
+  bool bDone = false;
+
+  while ( !( bDone = bReady( ) ) && !isClosed( ) )
+  {
+    cvWait_.wait( lock );
+  }
+
+  waiters_.fetch_sub( 1, std::memory_order_relaxed );
+  return bDone;
+}
+
+} // namespace timing
+
+} // namespace components
+
+#endif // __TIMING_DATAFLOW_H__
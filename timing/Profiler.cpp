@@ -0,0 +1,360 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Profiler.cpp
+//  Author  : Anthony Islas
+//  Purpose : Profiler thread registration and Chrome trace export
+//  Group   : Timing
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Profiler.hpp"
+
+namespace components
+{
+
+namespace timing
+{
+
+namespace
+{
+
+//
+// Every ring allocated. Rings outlive their threads so scopes from finished
+// workers still show up in the next dump, after which they are free for new
+// threads
+//
+std::mutex                                    g_mRings;
+std::vector< std::unique_ptr< ProfileRing > > g_vRings;
+std::vector< ProfileRing* >                   g_vRetired;
+std::vector< ProfileRing* >                   g_vFree;
+
+//
+// Retires the calling thread's ring when the thread exits
+//
+struct sRingGuard
+{
+  ProfileRing* pRing;
+
+  sRingGuard( ) : pRing( nullptr ) { }
+
+  ~sRingGuard( )
+  {
+    if ( pRing != nullptr )
+    {
+      std::lock_guard< std::mutex > lock( g_mRings );
+      g_vRetired.push_back( pRing );
+    }
+  }
+};
+
+//**********************************************************************************
+//
+//  recycleRetired
+//
+//  \brief Move the rings of exited threads, already dumped, to the free list
+//
+//  \return none
+//
+//**********************************************************************************
+void recycleRetired( )
+{
+  g_vFree.insert( g_vFree.end( ), g_vRetired.begin( ), g_vRetired.end( ) );
+  g_vRetired.clear( );
+}
+
+//
+// TSC / wall clock pair taken when the first ring registers, used to convert
+// ticks to microseconds at dump time
+//
+uint64_t                              g_u64TscAnchor = 0;
+std::chrono::steady_clock::time_point g_tpAnchor;
+
+} // namespace
+
+//**********************************************************************************
+//
+//  writeJsonString
+//
+//  \brief Write a string as a quoted JSON value
+//
+//  \param rOut  stream to write to
+//  \param pName string to escape, may be null
+//
+//  \return none
+//
+//**********************************************************************************
+void writeJsonString( std::ostream& rOut, const char* pName )
+{
+  rOut << '"';
+  for ( const char* pChar = pName; pChar != nullptr && *pChar != '\0'; pChar++ )
+  {
+    if ( *pChar == '"' || *pChar == '\\' )
+    {
+      rOut << '\\' << *pChar;
+    }
+    else if ( static_cast< unsigned char >( *pChar ) < 0x20 )
+    {
+      rOut << ' ';
+    }
+    else
+    {
+      rOut << *pChar;
+    }
+  }
+  rOut << '"';
+}
+
+
+thread_local ProfileRing* Profiler::pThreadRing_ = nullptr;
+
+//**********************************************************************************
+//
+//  ProfileRing::ProfileRing
+//
+//  \brief Empty ring for a single thread
+//
+//  \param uiThreadId id reported as "tid" in the trace
+//
+//  \return ProfileRing
+//
+//**********************************************************************************
+ProfileRing::ProfileRing( unsigned int uiThreadId ) :
+                          head_      ( 0          ),
+                          uiThreadId_( uiThreadId )
+{ }
+
+//**********************************************************************************
+//
+//  Profiler::registerThread
+//
+//  \brief Give the calling thread a ring
+//
+//  Cold path taken on the first scope recorded by each thread. A dumped ring of
+//  an exited thread is reused, id included, before allocating. Once too many
+//  undumped rings are retired the oldest is reused and its scopes dropped
+//
+//  \return ring now owned by the calling thread
+//
+//**********************************************************************************
+ProfileRing* Profiler::registerThread( )
+{
+  static thread_local sRingGuard sGuard;
+
+  std::lock_guard< std::mutex > lock( g_mRings );
+
+  if ( g_vRings.empty( ) )
+  {
+    g_tpAnchor     = std::chrono::steady_clock::now( );
+    g_u64TscAnchor = readTsc( );
+  }
+
+  ProfileRing* pRing = nullptr;
+
+  if ( !g_vFree.empty( ) )
+  {
+    pRing = g_vFree.back( );
+    g_vFree.pop_back( );
+  }
+  else if ( g_vRetired.size( ) >= COMPONENTS_PROFILE_RETIRED_RINGS )
+  {
+    pRing = g_vRetired.front( );
+    g_vRetired.erase( g_vRetired.begin( ) );
+  }
+
+  if ( pRing != nullptr )
+  {
+    pRing->clear( );
+  }
+  else
+  {
+    g_vRings.push_back(
+      std::unique_ptr< ProfileRing >(
+        new ProfileRing( static_cast< unsigned int >( g_vRings.size( ) + 1 ) ) ) );
+    pRing = g_vRings.back( ).get( );
+  }
+
+  sGuard.pRing = pRing;
+  pThreadRing_ = pRing;
+  return pRing;
+}
+
+//**********************************************************************************
+//
+//  Profiler::ticksPerMicro
+//
+//  \brief Measure the counter rate against the steady clock
+//
+//  Uses the anchor from the first registration, if that was too recent to be
+//  accurate a short calibration window is slept through instead
+//
+//  \return counter ticks per microsecond
+//
+//**********************************************************************************
+double Profiler::ticksPerMicro( )
+{
+  std::chrono::steady_clock::time_point tpStart = g_tpAnchor;
+  uint64_t                              u64Start = g_u64TscAnchor;
+
+  std::chrono::steady_clock::time_point tpNow  = std::chrono::steady_clock::now( );
+  uint64_t                              u64Now = readTsc( );
+
+  if ( tpNow - tpStart < std::chrono::milliseconds( 10 ) )
+  {
+    tpStart  = tpNow;
+    u64Start = u64Now;
+    std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    tpNow  = std::chrono::steady_clock::now( );
+    u64Now = readTsc( );
+  }
+
+  double fp64Micro = std::chrono::duration< double, std::micro >( tpNow - tpStart ).count( );
+
+  return ( fp64Micro > 0.0 ) ? static_cast< double >( u64Now - u64Start ) / fp64Micro : 1.0;
+}
+
+//**********************************************************************************
+//
+//  Profiler::writeChromeTrace
+//
+//  \brief Write all recorded scopes as Chrome trace-event JSON
+//
+//  \param rOut stream to write to
+//
+//  Produces complete ( "ph" : "X" ) events, timestamps relative to the first
+//  registered thread. Load the result in chrome://tracing or Perfetto. Rings of
+//  threads that exited since the last dump are released for reuse
+//
+//  \return none
+//
+//**********************************************************************************
+void Profiler::writeChromeTrace( std::ostream& rOut )
+{
+  std::lock_guard< std::mutex > lock( g_mRings );
+
+  double   fp64TicksPerMicro = g_vRings.empty( ) ? 1.0 : ticksPerMicro( );
+  uint64_t u64Origin         = g_u64TscAnchor;
+  bool     bFirst            = true;
+
+  std::ios::fmtflags flags     = rOut.flags( );
+  std::streamsize    precision = rOut.precision( );
+
+  rOut << std::fixed << std::setprecision( 3 ) << "{\"traceEvents\":[";
+
+  for ( size_t i = 0; i < g_vRings.size( ); i++ )
+  {
+    const ProfileRing& rRing = *g_vRings[ i ];
+
+    rRing.visit(
+      [ & ]( const char* pName, uint64_t u64Start, uint64_t u64Stop )
+      {
+        double fp64Ts  = static_cast< double >( static_cast< int64_t >( u64Start - u64Origin ) )
+                         / fp64TicksPerMicro;
+        double fp64Dur = static_cast< double >( u64Stop - u64Start ) / fp64TicksPerMicro;
+
+        rOut << ( bFirst ? "\n" : ",\n" ) << "{\"name\":";
+        writeJsonString( rOut, pName );
+        rOut << ",\"cat\":\"components\",\"ph\":\"X\""
+             << ",\"ts\":"  << fp64Ts
+             << ",\"dur\":" << fp64Dur
+             << ",\"pid\":1,\"tid\":" << rRing.threadId( ) << "}";
+        bFirst = false;
+      } );
+  }
+
+  rOut << "\n],\"displayTimeUnit\":\"ns\"}\n";
+
+  recycleRetired( );
+
+  rOut.flags    ( flags     );
+  rOut.precision( precision );
+}
+
+//**********************************************************************************
+//
+//  Profiler::dumpChromeTrace
+//
+//  \brief Write the trace to a file
+//
+//  \param ssPath path to the output .json
+//
+//  \return successful write
+//
+//**********************************************************************************
+bool Profiler::dumpChromeTrace( const std::string& ssPath )
+{
+  std::ofstream ofFile( ssPath.c_str( ) );
+
+  if ( !ofFile.is_open( ) )
+  {
+    std::cerr << "Error at: " << __FILE__ << ":"
+                              << __LINE__ << " unable to open file \""
+                              << ssPath   << "\"" << std::endl;
+    return false;
+  }
+
+  writeChromeTrace( ofFile );
+  return ofFile.good( );
+}
+
+//**********************************************************************************
+//
+//  Profiler::reset
+//
+//  \brief Drop all recorded scopes
+//
+//  \return none
+//
+//**********************************************************************************
+void Profiler::reset( )
+{
+  std::lock_guard< std::mutex > lock( g_mRings );
+
+  for ( size_t i = 0; i < g_vRings.size( ); i++ )
+  {
+    g_vRings[ i ]->clear( );
+  }
+
+  recycleRetired( );
+}
+
+//**********************************************************************************
+//
+//  Profiler::rings
+//
+//  \brief Number of rings allocated
+//
+//  \return count
+//
+//**********************************************************************************
+size_t Profiler::rings( )
+{
+  std::lock_guard< std::mutex > lock( g_mRings );
+  return g_vRings.size( );
+}
+
+} // namespace timing
+
+} // namespace components
@@ -0,0 +1,260 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Profiler.hpp
+//  Author  : Anthony Islas
+//  Purpose : Low overhead scoped profiler, scopes are stamped with the TSC into
+//            per-thread rings and can be dumped as Chrome trace-event JSON
+//  Group   : Timing
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __TIMING_PROFILER_H__
+#define __TIMING_PROFILER_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#endif
+
+//
+// Number of scopes kept per thread, oldest scopes are overwritten once full
+//
+#ifndef COMPONENTS_PROFILE_RING_SIZE
+#define COMPONENTS_PROFILE_RING_SIZE 16384
+#endif
+
+//
+// Rings of exited threads kept for the next dump, beyond this the oldest is
+// handed to a new thread and its scopes are lost
+//
+#ifndef COMPONENTS_PROFILE_RETIRED_RINGS
+#define COMPONENTS_PROFILE_RETIRED_RINGS 8
+#endif
+
+//
+// PROFILE_SCOPE( "name" ) times the enclosing scope. It compiles away entirely
+// unless COMPONENTS_PROFILE is defined. The name must be a string literal ( or
+// otherwise outlive the trace dump ) since only the pointer is recorded
+//
+#define PROFILE_CONCAT_IMPL( a, b ) a##b
+#define PROFILE_CONCAT( a, b )      PROFILE_CONCAT_IMPL( a, b )
+
+#ifdef COMPONENTS_PROFILE
+  #define PROFILE_SCOPE( name ) \
+    ::components::timing::ScopedTimer PROFILE_CONCAT( profileScope_, __LINE__ )( name )
+#else
+  #define PROFILE_SCOPE( name ) ( void )0
+#endif
+
+namespace components
+{
+
+namespace timing
+{
+
+//
+// Raw timestamp counter, TSC where available
+//
+inline uint64_t readTsc( )
+{
+#if defined( __x86_64__ ) || defined( __i386__ )
+  return __rdtsc( );
+#elif defined( __aarch64__ )
+  uint64_t u64Ticks;
+  asm volatile( "mrs %0, cntvct_el0" : "=r"( u64Ticks ) );
+  return u64Ticks;
+#else
+  return static_cast< uint64_t >(
+    std::chrono::steady_clock::now( ).time_since_epoch( ).count( ) );
+#endif
+}
+
+//
+// Write a string as a quoted JSON value, shared by the JSON dumps
+//
+void writeJsonString( std::ostream& rOut, const char* pName );
+
+//
+// Single-writer ring of scopes owned by one thread. Fields are relaxed atomics
+// so the dumper may read while the owner keeps writing, torn slots are
+// discarded using the head before and after the copy
+//
+class ProfileRing
+{
+public:
+  static const uint64_t RING_SIZE = COMPONENTS_PROFILE_RING_SIZE;
+  static_assert( ( RING_SIZE & ( RING_SIZE - 1 ) ) == 0,
+                 "COMPONENTS_PROFILE_RING_SIZE must be a power of two" );
+
+  explicit ProfileRing( unsigned int uiThreadId );
+
+  inline void push( const char* pName, uint64_t u64Start, uint64_t u64Stop )
+  {
+    uint64_t u64Head = head_.load( std::memory_order_relaxed );
+    sSlot_t& sSlot   = slots_[ u64Head & ( RING_SIZE - 1 ) ];
+
+    //
+    // Pairs with the fence in visit( ), a reader that sees any of these stores
+    // also sees the head that claimed the slot
+    //
+    std::atomic_thread_fence( std::memory_order_release );
+
+    sSlot.pName   .store( pName,    std::memory_order_relaxed );
+    sSlot.u64Start.store( u64Start, std::memory_order_relaxed );
+    sSlot.u64Stop .store( u64Stop,  std::memory_order_relaxed );
+
+    head_.store( u64Head + 1, std::memory_order_release );
+  }
+
+  unsigned int threadId( ) const { return uiThreadId_; }
+
+  //
+  // Visit every intact scope, fn( pName, u64Start, u64Stop )
+  //
+  template< typename Fn >
+  void visit( Fn fn ) const;
+
+  void clear( ) { head_.store( 0, std::memory_order_release ); }
+
+private:
+  typedef struct sSlotStructure
+  {
+    std::atomic< const char* > pName;
+    std::atomic< uint64_t >    u64Start;
+    std::atomic< uint64_t >    u64Stop;
+  } sSlot_t;
+
+  std::atomic< uint64_t > head_;
+  unsigned int            uiThreadId_;
+  sSlot_t                 slots_[ RING_SIZE ];
+};
+
+//
+// Global access to all thread rings
+//
+class Profiler
+{
+public:
+  //
+  // Hot path, append a finished scope to the calling thread's ring
+  //
+  static inline void record( const char* pName, uint64_t u64Start, uint64_t u64Stop )
+  {
+    ProfileRing* pRing = pThreadRing_;
+    if ( pRing == nullptr )
+    {
+      pRing = registerThread( );
+    }
+    pRing->push( pName, u64Start, u64Stop );
+  }
+
+  static void writeChromeTrace( std::ostream& rOut );
+  static bool dumpChromeTrace ( const std::string& ssPath );
+
+  //
+  // Drop all recorded scopes, threads should be quiescent
+  //
+  static void reset( );
+
+  //
+  // Rings allocated, one per live thread plus retired ones awaiting a dump.
+  // Rings of exited threads are reused once dumped or reset
+  //
+  static size_t rings( );
+
+private:
+  static ProfileRing* registerThread( );
+  static double       ticksPerMicro ( );
+
+  static thread_local ProfileRing* pThreadRing_;
+};
+
+//
+// RAII scope stamp, prefer PROFILE_SCOPE so it can be compiled out
+//
+class ScopedTimer
+{
+public:
+  explicit ScopedTimer( const char* pName ) :
+                        pName_   ( pName      ),
+                        u64Start_( readTsc( ) )
+  { }
+
+  ~ScopedTimer( ) { Profiler::record( pName_, u64Start_, readTsc( ) ); }
+
+  ScopedTimer( const ScopedTimer& ) = delete;
+  ScopedTimer& operator=( const ScopedTimer& ) = delete;
+
+private:
+  const char* pName_;
+  uint64_t    u64Start_;
+};
+
+
+//**********************************************************************************
+//
+//  ProfileRing::visit
+//
+//  \brief Walk the scopes currently held in the ring
+//
+//  \param fn callable taking ( const char*, uint64_t, uint64_t )
+//
+//  Copies each slot then re-reads the head, any slot the writer may have lapped
+//  during the walk is skipped rather than reported torn
+//
+//  \return none
+//
+//**********************************************************************************
+template< typename Fn >
+void ProfileRing::visit( Fn fn ) const
+{
+  uint64_t u64Head  = head_.load( std::memory_order_acquire );
+  uint64_t u64First = ( u64Head > RING_SIZE ) ? u64Head - RING_SIZE : 0;
+
+  for ( uint64_t u64Idx = u64First; u64Idx < u64Head; u64Idx++ )
+  {
+    const sSlot_t& sSlot    = slots_[ u64Idx & ( RING_SIZE - 1 ) ];
+    const char*    pName    = sSlot.pName   .load( std::memory_order_relaxed );
+    uint64_t       u64Start = sSlot.u64Start.load( std::memory_order_relaxed );
+    uint64_t       u64Stop  = sSlot.u64Stop .load( std::memory_order_relaxed );
+
+    std::atomic_thread_fence( std::memory_order_acquire );
+
+    //
+    // Writer reached this slot again while we were reading it
+    //
+    uint64_t u64Now = head_.load( std::memory_order_relaxed );
+    if ( u64Now >= u64Idx + RING_SIZE )
+    {
+      continue;
+    }
+
+    fn( pName, u64Start, u64Stop );
+  }
+} // ProfileRing::visit
+
+} // namespace timing
+
+} // namespace components
+
+#endif // __TIMING_PROFILER_H__
@@ -0,0 +1,364 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : Queue.hpp
+//  Author  : Anthony Islas
+//  Purpose : Bounded lock-free ring buffers, single producer / single consumer
+//            and multi producer / multi consumer
+//  Group   : Timing
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#ifndef __TIMING_QUEUE_H__
+#define __TIMING_QUEUE_H__
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace components
+{
+
+namespace timing
+{
+
+//
+// Padding keeping producer and consumer indices on separate lines
+//
+static const size_t CACHE_LINE_SIZE = 64;
+
+//
+// Smallest power of two >= uiValue ( minimum 2 )
+//
+inline size_t roundUpPow2( size_t uiValue )
+{
+  size_t uiPow2 = 2;
+  while ( uiPow2 < uiValue )
+  {
+    uiPow2 <<= 1;
+  }
+  return uiPow2;
+}
+
+//
+// Single producer / single consumer bounded ring. T must be default
+// constructible and move assignable
+//
+template< typename T >
+class SpscQueue
+{
+public:
+  explicit SpscQueue( size_t uiCapacity );
+
+  bool tryPush( T&& value );
+  bool tryPush( const T& value ) { T copy( value ); return tryPush( std::move( copy ) ); }
+  bool tryPop ( T& rValue );
+
+  size_t capacity( ) const { return uiMask_ + 1; }
+  bool   empty   ( ) const;
+
+private:
+  const size_t     uiMask_;
+  std::vector< T > vBuffer_;
+
+  //
+  // Consumer side, plus its stale view of the producer
+  //
+  char                  padHead_[ CACHE_LINE_SIZE ];
+  std::atomic< size_t > head_;
+  size_t                cachedTail_;
+
+  //
+  // Producer side, plus its stale view of the consumer
+  //
+  char                  padTail_[ CACHE_LINE_SIZE ];
+  std::atomic< size_t > tail_;
+  size_t                cachedHead_;
+  char                  padEnd_ [ CACHE_LINE_SIZE ];
+};
+
+//
+// Multi producer / multi consumer bounded ring ( Vyukov ), each cell carries a
+// sequence number so producers and consumers only contend on their own index
+//
+template< typename T >
+class MpmcQueue
+{
+public:
+  explicit MpmcQueue( size_t uiCapacity );
+
+  bool tryPush( T&& value );
+  bool tryPush( const T& value ) { T copy( value ); return tryPush( std::move( copy ) ); }
+  bool tryPop ( T& rValue );
+
+  size_t capacity( ) const { return uiMask_ + 1; }
+  bool   empty   ( ) const;
+
+private:
+  typedef struct sCellStructure
+  {
+    std::atomic< size_t > sequence;
+    T                     value;
+  } sCell_t;
+
+  const size_t           uiMask_;
+  std::vector< sCell_t > vCells_;
+
+  char                  padTail_[ CACHE_LINE_SIZE ];
+  std::atomic< size_t > tail_;
+  char                  padHead_[ CACHE_LINE_SIZE ];
+  std::atomic< size_t > head_;
+  char                  padEnd_ [ CACHE_LINE_SIZE ];
+};
+
+
+//**********************************************************************************
+//
+//  SpscQueue::SpscQueue
+//
+//  \brief Bounded single producer / single consumer queue
+//
+//  \param uiCapacity number of elements, rounded up to a power of two
+//
+//  \return SpscQueue
+//
+//**********************************************************************************
+template< typename T >
+SpscQueue< T >::SpscQueue( size_t uiCapacity ) :
+                           uiMask_    ( roundUpPow2( uiCapacity ) - 1 ),
+                           vBuffer_   ( uiMask_ + 1                   ),
+                           head_      ( 0                             ),
+                           cachedTail_( 0                             ),
+                           tail_      ( 0                             ),
+                           cachedHead_( 0                             )
+{ }
+
+//**********************************************************************************
+//
+//  SpscQueue::tryPush
+//
+//  \brief Append an element, producer thread only
+//
+//  \param value element to move in
+//
+//  \return false if the queue is full
+//
+//**********************************************************************************
+template< typename T >
+bool SpscQueue< T >::tryPush( T&& value )
+{
+  size_t uiTail = tail_.load( std::memory_order_relaxed );
+
+  if ( uiTail - cachedHead_ > uiMask_ )
+  {
+    cachedHead_ = head_.load( std::memory_order_acquire );
+    if ( uiTail - cachedHead_ > uiMask_ )
+    {
+      return false;
+    }
+  }
+
+  vBuffer_[ uiTail & uiMask_ ] = std::move( value );
+  tail_.store( uiTail + 1, std::memory_order_release );
+  return true;
+}
+
+//**********************************************************************************
+//
+//  SpscQueue::tryPop
+//
+//  \brief Remove the oldest element, consumer thread only
+//
+//  \param rValue receives the element
+//
+//  \return false if the queue is empty
+//
+//**********************************************************************************
+template< typename T >
+bool SpscQueue< T >::tryPop( T& rValue )
+{
+  size_t uiHead = head_.load( std::memory_order_relaxed );
+
+  if ( uiHead == cachedTail_ )
+  {
+    cachedTail_ = tail_.load( std::memory_order_acquire );
+    if ( uiHead == cachedTail_ )
+    {
+      return false;
+    }
+  }
+
+  rValue = std::move( vBuffer_[ uiHead & uiMask_ ] );
+  head_.store( uiHead + 1, std::memory_order_release );
+  return true;
+}
+
+//**********************************************************************************
+//
+//  SpscQueue::empty
+//
+//  \brief Approximate emptiness, exact only from the consumer thread
+//
+//  \return true if no elements are queued
+//
+//**********************************************************************************
+template< typename T >
+bool SpscQueue< T >::empty( ) const
+{
+  return head_.load( std::memory_order_acquire ) == tail_.load( std::memory_order_acquire );
+}
+
+//**********************************************************************************
+//
+//  MpmcQueue::MpmcQueue
+//
+//  \brief Bounded multi producer / multi consumer queue
+//
+//  \param uiCapacity number of elements, rounded up to a power of two
+//
+//  \return MpmcQueue
+//
+//**********************************************************************************
+template< typename T >
+MpmcQueue< T >::MpmcQueue( size_t uiCapacity ) :
+                           uiMask_( roundUpPow2( uiCapacity ) - 1 ),
+                           vCells_( uiMask_ + 1                   ),
+                           tail_  ( 0                             ),
+                           head_  ( 0                             )
+{
+  for ( size_t i = 0; i < vCells_.size( ); i++ )
+  {
+    vCells_[ i ].sequence.store( i, std::memory_order_relaxed );
+  }
+}
+
+//**********************************************************************************
+//
+//  MpmcQueue::tryPush
+//
+//  \brief Append an element from any thread
+//
+//  \param value element to move in
+//
+//  \return false if the queue is full
+//
+//**********************************************************************************
+template< typename T >
+bool MpmcQueue< T >::tryPush( T&& value )
+{
+  sCell_t* pCell;
+  size_t   uiPos = tail_.load( std::memory_order_relaxed );
+
+  for ( ;; )
+  {
+    pCell = &vCells_[ uiPos & uiMask_ ];
+
+    size_t    uiSeq = pCell->sequence.load( std::memory_order_acquire );
+    ptrdiff_t iDiff = static_cast< ptrdiff_t >( uiSeq ) - static_cast< ptrdiff_t >( uiPos );
+
+    if ( iDiff == 0 )
+    {
+      if ( tail_.compare_exchange_weak( uiPos, uiPos + 1, std::memory_order_relaxed ) )
+      {
+        break;
+      }
+    }
+    else if ( iDiff < 0 )
+    {
+      //
+      // Cell still holds an element from the previous lap
+      //
+      return false;
+    }
+    else
+    {
+      uiPos = tail_.load( std::memory_order_relaxed );
+    }
+  }
+
+  pCell->value = std::move( value );
+  pCell->sequence.store( uiPos + 1, std::memory_order_release );
+  return true;
+}
+
+//**********************************************************************************
+//
+//  MpmcQueue::tryPop
+//
+//  \brief Remove the oldest element from any thread
+//
+//  \param rValue receives the element
+//
+//  \return false if the queue is empty
+//
+//**********************************************************************************
+template< typename T >
+bool MpmcQueue< T >::tryPop( T& rValue )
+{
+  sCell_t* pCell;
+  size_t   uiPos = head_.load( std::memory_order_relaxed );
+
+  for ( ;; )
+  {
+    pCell = &vCells_[ uiPos & uiMask_ ];
+
+    size_t    uiSeq = pCell->sequence.load( std::memory_order_acquire );
+    ptrdiff_t iDiff = static_cast< ptrdiff_t >( uiSeq ) - static_cast< ptrdiff_t >( uiPos + 1 );
+
+    if ( iDiff == 0 )
+    {
+      if ( head_.compare_exchange_weak( uiPos, uiPos + 1, std::memory_order_relaxed ) )
+      {
+        break;
+      }
+    }
+    else if ( iDiff < 0 )
+    {
+      return false;
+    }
+    else
+    {
+      uiPos = head_.load( std::memory_order_relaxed );
+    }
+  }
+
+  rValue = std::move( pCell->value );
+  pCell->sequence.store( uiPos + uiMask_ + 1, std::memory_order_release );
+  return true;
+}
+
+//**********************************************************************************
+//
+//  MpmcQueue::empty
+//
+//  \brief Approximate emptiness
+//
+//  \return true if no elements appeared queued at the time of the call
+//
+//**********************************************************************************
+template< typename T >
+bool MpmcQueue< T >::empty( ) const
+{
+  return head_.load( std::memory_order_acquire ) >= tail_.load( std::memory_order_acquire );
+}
+
+} // namespace timing
+
+} // namespace components
+
+#endif // __TIMING_QUEUE_H__
@@ -0,0 +1,103 @@
+////////////////////////////////////////////////////////////////////////////////////
+//
+//     _____    ____ _       ____ _        __ _      __ _  __ _  ______ _   ___ _
+//    / /| |]  |  __ \\     / ___ \\      / \ \\    |   \\/   |]|  _____|] / ___|]
+//   / //| |]  | |] \ \\   | |]  \_|]    / //\ \\   | |\ / /| |]| |]___ _ ( ((_ _
+//  / //_| |]_ | |]  ) ))  | |]  __ _   / _____ \\  | |]\_/ | |]|  _____|] \___ \\
+// |_____   _|]| |]_/ //   | |]__/  |] / //    \ \\ | |]    | |]| |]___ _   ___) ))
+//       |_|]  |_____//     \_____/|]]/_//      \_\\|_|]    |_|]|_______|] |____//
+//
+//
+////////////////////////////////////////////////////////////////////////////////////
+//
+//
+//  File    : PackTool.cpp
+//  Author  : Anthony Islas
+//  Purpose : Command line pack builder
+//  Group   : Tools
+//
+//  TODO    : None
+//
+//  License : None
+//
+////////////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>
+#include <string>
+
+#include "Pack.hpp"
+#include "Parser.hpp"
+
+using namespace components;
+using namespace components::resources;
+
+//**********************************************************************************
+//
+//  endsWith
+//
+//  \brief Suffix check
+//
+//  \param ssText
+//  \param ssSuffix
+//
+//  \return true if ssText ends with ssSuffix
+//
+//**********************************************************************************
+static bool endsWith( const std::string& ssText, const std::string& ssSuffix )
+{
+  return ssText.size( ) >= ssSuffix.size( ) &&
+         ssText.compare( ssText.size( ) - ssSuffix.size( ), ssSuffix.size( ), ssSuffix ) == 0;
+}
+
+//**********************************************************************************
+//
+//  main
+//
+//  \brief PackTool output.pack [ --raw ] file...
+//
+//  Each file is tagged with its path as given. .gsf files are parsed now and
+//  stored as trees unless --raw is passed, everything else is stored as bytes
+//
+//  \return 0 on success
+//
+//**********************************************************************************
+int main( int argc, char** argv )
+{
+  if ( argc < 3 )
+  {
+    std::cerr << "usage: " << argv[ 0 ] << " output.pack [ --raw ] file..." << std::endl;
+    return 1;
+  }
+
+  PackBuilder builder;
+  Parser      parser;
+  bool        bRaw = false;
+
+  for ( int i = 2; i < argc; i++ )
+  {
+    std::string ssPath( argv[ i ] );
+
+    if ( ssPath == "--raw" )
+    {
+      bRaw = true;
+      continue;
+    }
+
+    bool bAdded = ( !bRaw && endsWith( ssPath, ".gsf" ) ) ?
+                  builder.addGsf ( ssPath, ssPath, parser ) :
+                  builder.addFile( ssPath, ssPath );
+
+    if ( !bAdded )
+    {
+      return 1;
+    }
+  }
+
+  if ( !builder.write( argv[ 1 ] ) )
+  {
+    return 1;
+  }
+
+  std::cout << "Packed " << builder.size( ) << " entries into " << argv[ 1 ] << std::endl;
+  return 0;
+}